@@ -208,7 +208,7 @@ static NSString *kRelatedValue = @"related";
 				self.parsingArticle = NO;
 			}
 			else if (isArticle && EqualBytes(localName, "title", 5)) {
-				self.currentArticle.title = [self decodeHTMLEntities:SAXParser.currentStringWithTrimmedWhitespace];
+				[self setArticleField:RSParsedArticleFieldTitle fromSAXParser:SAXParser baseURL:nil];
 			}
 			else if (!self.parsingArticle && !self.parsingSource && self.parsedFeed.title.length == 0) {
 				if (EqualBytes(localName, "title", 5)) {
@@ -224,19 +224,19 @@ static NSString *kRelatedValue = @"related";
 				self.parsingSource = NO;
 			}
 			else if (isArticle && EqualBytes(localName, "issued", 6)) { // Atom 0.3 date
-				self.currentArticle.datePublished = [self dateFromCharacters:SAXParser.currentCharacters];;
+				[self setArticleField:RSParsedArticleFieldDatePublished fromSAXParser:SAXParser baseURL:nil];
 			}
 			return;
 		case 7:
 			if (isArticle) {
 				if (EqualBytes(localName, "content", 7)) {
-					self.currentArticle.body = [self decodeHTMLEntities:SAXParser.currentStringWithTrimmedWhitespace];
+					[self setArticleField:RSParsedArticleFieldBody fromSAXParser:SAXParser baseURL:nil];
 				}
 				else if (EqualBytes(localName, "summary", 7)) {
-					self.currentArticle.abstract = [self decodeHTMLEntities:SAXParser.currentStringWithTrimmedWhitespace];
+					[self setArticleField:RSParsedArticleFieldAbstract fromSAXParser:SAXParser baseURL:nil];
 				}
 				else if (EqualBytes(localName, "updated", 7)) {
-					self.currentArticle.dateModified = [self dateFromCharacters:SAXParser.currentCharacters];
+					[self setArticleField:RSParsedArticleFieldDateModified fromSAXParser:SAXParser baseURL:nil];
 				}
 			}
 			return;
@@ -247,12 +247,12 @@ static NSString *kRelatedValue = @"related";
 				}
 			}
 			else if (isArticle && EqualBytes(localName, "modified", 8)) { // Atom 0.3 date
-				self.currentArticle.dateModified = [self dateFromCharacters:SAXParser.currentCharacters];;
+				[self setArticleField:RSParsedArticleFieldDateModified fromSAXParser:SAXParser baseURL:nil];
 			}
 			return;
 		case 9:
 			if (isArticle && EqualBytes(localName, "published", 9)) {
-				self.currentArticle.datePublished = [self dateFromCharacters:SAXParser.currentCharacters];
+				[self setArticleField:RSParsedArticleFieldDatePublished fromSAXParser:SAXParser baseURL:nil];
 			}
 			return;
 	}
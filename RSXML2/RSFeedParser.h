@@ -23,16 +23,25 @@
 //  SOFTWARE.
 
 #import <RSXML2/RSXMLParser.h>
+#import <RSXML2/RSParsedArticle.h>
 
-@class RSParsedFeed, RSParsedArticle;
+@class RSParsedFeed;
 
 /// Generic feed parser. Used for atom, RSS, and RDF feeds.
 @interface RSFeedParser : RSXMLParser<RSParsedFeed*>
 @property (nonatomic, readonly) RSParsedFeed *parsedFeed;
 @property (nonatomic, weak) RSParsedArticle *currentArticle;
+/**
+ Default: @c NO. If @c YES, article title, abstract, body, dates (and RSS links) are stored undecoded
+ and decoded on first access. Cheap if most articles are discarded after checking @c articleID.
+ Has no effect if a subclass overrides @c decodeHTMLEntities: or @c dateFromCharacters: (fields are decoded immediately).
+ */
+@property (nonatomic, assign) BOOL lazyDecoding;
 
 /// @return @c NSDate by parsing RFC 822 and 8601 date strings.
 - (NSDate *)dateFromCharacters:(NSData *)data;
 /// @return currentString by removing HTML encoded entities.
 - (NSString *)decodeHTMLEntities:(NSString *)str;
+/// Set @c field of @c currentArticle from current characters. Decoded now, or on first access if @c lazyDecoding is set.
+- (void)setArticleField:(RSParsedArticleField)field fromSAXParser:(RSSAXParser *)SAXParser baseURL:(NSURL *)baseURL;
 @end
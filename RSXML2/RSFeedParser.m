@@ -28,7 +28,16 @@
 #import "RSDateParser.h"
 #import "NSString+RSXML.h"
 
-@implementation RSFeedParser
+@implementation RSFeedParser {
+	BOOL _decodeLazily; // lazyDecoding and default decoding methods
+}
+
+/// Lazily decoded articles don't know the parser. They can only use the default implementations.
+static BOOL overridesDecodingMethods(Class cls) {
+	Class base = [RSFeedParser class];
+	return [cls instanceMethodForSelector:@selector(decodeHTMLEntities:)] != [base instanceMethodForSelector:@selector(decodeHTMLEntities:)]
+		|| [cls instanceMethodForSelector:@selector(dateFromCharacters:)] != [base instanceMethodForSelector:@selector(dateFromCharacters:)];
+}
 
 #pragma mark - RSXMLParserDelegate
 
@@ -36,6 +45,7 @@
 
 - (BOOL)xmlParserWillStartParsing {
 	_parsedFeed = [[RSParsedFeed alloc] initWithURL:self.documentURI];
+	_decodeLazily = self.lazyDecoding && !overridesDecodingMethods([self class]);
 	return YES;
 }
 
@@ -55,4 +65,32 @@
 	return [str rsxml_stringByDecodingHTMLEntities];
 }
 
+// docref in header
+- (void)setArticleField:(RSParsedArticleField)field fromSAXParser:(RSSAXParser *)SAXParser baseURL:(NSURL *)baseURL {
+	if (_decodeLazily) {
+		[self.currentArticle setRawCharacters:SAXParser.currentCharacters forField:field baseURL:baseURL];
+		return;
+	}
+	switch (field) {
+		case RSParsedArticleFieldTitle:
+			self.currentArticle.title = [self decodeHTMLEntities:SAXParser.currentStringWithTrimmedWhitespace];
+			break;
+		case RSParsedArticleFieldAbstract:
+			self.currentArticle.abstract = [self decodeHTMLEntities:SAXParser.currentStringWithTrimmedWhitespace];
+			break;
+		case RSParsedArticleFieldBody:
+			self.currentArticle.body = [self decodeHTMLEntities:SAXParser.currentStringWithTrimmedWhitespace];
+			break;
+		case RSParsedArticleFieldLink:
+			self.currentArticle.link = [SAXParser.currentStringWithTrimmedWhitespace absoluteURLWithBase:baseURL];
+			break;
+		case RSParsedArticleFieldDatePublished:
+			self.currentArticle.datePublished = [self dateFromCharacters:SAXParser.currentCharacters];
+			break;
+		case RSParsedArticleFieldDateModified:
+			self.currentArticle.dateModified = [self dateFromCharacters:SAXParser.currentCharacters];
+			break;
+	}
+}
+
 @end
@@ -29,5 +29,12 @@
 
 /// HTML parser for html header metadata. Used to extract feed and favicon URLs.
 @interface RSHTMLMetadataParser : RSXMLParser<RSHTMLMetadata*>
+/**
+ Default: @c NO. If @c YES, scan the document head for @c <link> tags without @c libxml.
+ Falls back to the @c libxml HTML parser if the markup is too malformed or not UTF-8 encoded.
+ */
+@property (nonatomic, assign) BOOL fastHeadScan;
+/// @c YES if the last parse with @c fastHeadScan enabled had to fall back to the @c libxml HTML parser.
+@property (nonatomic, readonly) BOOL fastScanFailed;
 
 @end
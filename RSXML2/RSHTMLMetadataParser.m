@@ -29,12 +29,269 @@
 #import "NSString+RSXML.h"
 #import "NSDictionary+RSXML.h"
 
+#pragma mark - Fast Head Scanner
+
+/// Attribute name and value as byte ranges into the original document. @c value is @c NULL if attribute has no value.
+typedef struct {
+	const char *name;
+	size_t nameLength;
+	const char *value;
+	size_t valueLength;
+} RSHTMLAttributeRange;
+
+enum { kMaxLinkAttributes = 16 };
+
+typedef enum {
+	RSHTMLTagOther = 0, // implies <body>
+	RSHTMLTagHead,      // allowed in <head>, attributes are skipped
+	RSHTMLTagRawText,   // skip content until closing tag
+	RSHTMLTagLink,
+	RSHTMLTagBody
+} RSHTMLTagKind;
+
+static inline BOOL isHTMLSpace(char c) {
+	return (c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\f');
+}
+
+static inline BOOL isTagNameChar(char c) {
+	return ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-');
+}
+
+static inline BOOL equalsIgnoreCase(const char *bytes, size_t length, const char *lowercase, size_t expectedLength) {
+	return (length == expectedLength && strncasecmp(bytes, lowercase, length) == 0);
+}
+
+static RSHTMLTagKind tagKind(const char *name, size_t length) {
+	switch (length) {
+		case 4:
+			if (equalsIgnoreCase(name, length, "link", 4)) return RSHTMLTagLink;
+			if (equalsIgnoreCase(name, length, "body", 4)) return RSHTMLTagBody;
+			if (equalsIgnoreCase(name, length, "html", 4)) return RSHTMLTagHead;
+			if (equalsIgnoreCase(name, length, "head", 4)) return RSHTMLTagHead;
+			if (equalsIgnoreCase(name, length, "meta", 4)) return RSHTMLTagHead;
+			if (equalsIgnoreCase(name, length, "base", 4)) return RSHTMLTagHead;
+			break;
+		case 5:
+			if (equalsIgnoreCase(name, length, "style", 5)) return RSHTMLTagRawText;
+			if (equalsIgnoreCase(name, length, "title", 5)) return RSHTMLTagRawText;
+			break;
+		case 6:
+			if (equalsIgnoreCase(name, length, "script", 6)) return RSHTMLTagRawText;
+			break;
+		case 8:
+			if (equalsIgnoreCase(name, length, "noscript", 8)) return RSHTMLTagHead;
+			if (equalsIgnoreCase(name, length, "template", 8)) return RSHTMLTagHead;
+			break;
+	}
+	return RSHTMLTagOther;
+}
+
+/**
+ Parse attributes of a start tag up to and including the closing @c '>'.
+ If @c attribs is @c NULL, attributes are skipped (but quotes are still respected).
+
+ @return Pointer after @c '>' or @c NULL if the tag is malformed or has more than @c max attributes.
+ */
+static const char *scanAttributes(const char *p, const char *end, RSHTMLAttributeRange *attribs, int *count, int max) {
+	int n = 0;
+	while (p < end) {
+		char c = *p;
+		if (isHTMLSpace(c) || c == '/') {
+			p++;
+			continue;
+		}
+		if (c == '>') {
+			if (count) *count = n;
+			return p + 1;
+		}
+		if (c == '"' || c == '\'' || c == '<' || c == '=') {
+			return NULL;
+		}
+		const char *name = p;
+		while (p < end && !isHTMLSpace(*p) && *p != '=' && *p != '>' && *p != '/') {
+			p++;
+		}
+		size_t nameLength = (size_t)(p - name);
+		while (p < end && isHTMLSpace(*p)) {
+			p++;
+		}
+		const char *value = NULL;
+		size_t valueLength = 0;
+		if (p < end && *p == '=') {
+			p++;
+			while (p < end && isHTMLSpace(*p)) {
+				p++;
+			}
+			if (p >= end) {
+				return NULL;
+			}
+			if (*p == '"' || *p == '\'') {
+				const char *close = memchr(p + 1, *p, (size_t)(end - p - 1));
+				if (!close) {
+					return NULL;
+				}
+				value = p + 1;
+				valueLength = (size_t)(close - value);
+				p = close + 1;
+			} else {
+				value = p;
+				while (p < end && !isHTMLSpace(*p) && *p != '>') {
+					p++;
+				}
+				valueLength = (size_t)(p - value);
+			}
+		}
+		if (attribs) {
+			if (n >= max) {
+				return NULL;
+			}
+			attribs[n] = (RSHTMLAttributeRange){ name, nameLength, value, valueLength };
+		}
+		n++;
+	}
+	return NULL; // EOF inside tag
+}
+
+/// @return Pointer after the closing tag @c </name> or @c NULL if not found.
+static const char *skipRawText(const char *p, const char *end, const char *name, size_t nameLength) {
+	while ((p = memchr(p, '<', (size_t)(end - p))) != NULL) {
+		p++;
+		if ((size_t)(end - p) > nameLength + 1 && *p == '/' && strncasecmp(p + 1, name, nameLength) == 0 && !isTagNameChar(p[1 + nameLength])) {
+			const char *close = memchr(p, '>', (size_t)(end - p));
+			return (close ? close + 1 : NULL);
+		}
+	}
+	return NULL;
+}
+
+typedef void (*RSHTMLLinkCallback)(void *context, const RSHTMLAttributeRange *attribs, int count);
+
+/**
+ Scan the @c <head> of an HTML document and report each @c <link> tag.
+ Stops at @c <body> or wherever @c libxml would imply a body (unknown tag or text content).
+ Uses @c memchr() which is vectorized by libc.
+
+ @return @c NO if the markup is too malformed (or not ASCII compatible) for the fast path.
+ */
+static BOOL scanHTMLHead(const char *bytes, size_t length, RSHTMLLinkCallback callback, void *context) {
+	const char *p = bytes;
+	const char *end = bytes + length;
+	// UTF-16 and UTF-32 are not supported
+	if (length >= 2 && (((unsigned char)p[0] == 0xFE && (unsigned char)p[1] == 0xFF) || ((unsigned char)p[0] == 0xFF && (unsigned char)p[1] == 0xFE))) {
+		return NO;
+	}
+	if (memchr(p, 0, (length < 512 ? length : 512)) != NULL) {
+		return NO;
+	}
+	RSHTMLAttributeRange attribs[kMaxLinkAttributes];
+	while (p < end) {
+		const char *tag = memchr(p, '<', (size_t)(end - p));
+		for (const char *t = p; t < (tag ? tag : end); t++) {
+			if (!isHTMLSpace(*t)) {
+				return YES; // text content implies <body>
+			}
+		}
+		if (!tag) {
+			return YES;
+		}
+		p = tag + 1;
+		if (p >= end) {
+			return YES;
+		}
+		if (*p == '!' || *p == '?') {
+			if (end - p >= 3 && p[1] == '-' && p[2] == '-') {
+				const char *close = memmem(p + 3, (size_t)(end - p - 3), "-->", 3);
+				if (!close) {
+					return NO;
+				}
+				p = close + 3;
+			} else {
+				const char *close = memchr(p, '>', (size_t)(end - p));
+				if (!close) {
+					return NO;
+				}
+				p = close + 1;
+			}
+			continue;
+		}
+		BOOL isClosingTag = (*p == '/');
+		if (isClosingTag) {
+			p++;
+		}
+		const char *name = p;
+		while (p < end && isTagNameChar(*p)) {
+			p++;
+		}
+		size_t nameLength = (size_t)(p - name);
+		if (nameLength == 0) {
+			return YES; // '<' as text content
+		}
+		RSHTMLTagKind kind = tagKind(name, nameLength);
+		if (kind == RSHTMLTagBody || kind == RSHTMLTagOther) {
+			return YES;
+		}
+		if (isClosingTag) {
+			const char *close = memchr(p, '>', (size_t)(end - p));
+			if (!close) {
+				return NO;
+			}
+			p = close + 1;
+			continue;
+		}
+		int count = 0;
+		p = scanAttributes(p, end, (kind == RSHTMLTagLink ? attribs : NULL), &count, kMaxLinkAttributes);
+		if (!p) {
+			return NO;
+		}
+		if (kind == RSHTMLTagLink) {
+			callback(context, attribs, count);
+		} else if (kind == RSHTMLTagRawText && p[-2] != '/') {
+			p = skipRawText(p, end, name, nameLength);
+			if (!p) {
+				return NO;
+			}
+		}
+	}
+	return YES;
+}
+
+
 @interface RSHTMLMetadataParser()
 @property (nonatomic) NSString *faviconLink;
 @property (nonatomic) NSMutableArray<RSHTMLMetadataIconLink*> *iconLinks;
 @property (nonatomic) NSMutableArray<RSHTMLMetadataFeedLink*> *feedLinks;
+@property (nonatomic, readwrite) BOOL fastScanFailed;
+- (void)parseLinkItemWithAttributes:(NSDictionary*)attribs;
 @end
 
+/// Callback for @c scanHTMLHead(). Builds the same attributes dictionary as @c attributesDictionaryHTML: would.
+static void foundLinkTag(void *context, const RSHTMLAttributeRange *attribs, int count) {
+	RSHTMLMetadataParser *parser = (__bridge RSHTMLMetadataParser *)context;
+	if (parser.fastScanFailed) {
+		return;
+	}
+	NSMutableDictionary *d = [NSMutableDictionary dictionaryWithCapacity:(NSUInteger)count];
+	for (int i = 0; i < count; i++) {
+		NSString *key = [[[NSString alloc] initWithBytes:attribs[i].name length:attribs[i].nameLength encoding:NSUTF8StringEncoding] lowercaseString];
+		NSString *value = @"";
+		if (attribs[i].value) {
+			value = [[NSString alloc] initWithBytes:attribs[i].value length:attribs[i].valueLength encoding:NSUTF8StringEncoding];
+			if (value && memchr(attribs[i].value, '&', attribs[i].valueLength)) {
+				value = [value rsxml_stringByDecodingHTMLEntities];
+			}
+		}
+		if (!key || !value) {
+			parser.fastScanFailed = YES; // not UTF-8, let libxml handle the encoding
+			return;
+		}
+		if (!d[key]) { // libxml ignores redefined attributes
+			d[key] = value;
+		}
+	}
+	[parser parseLinkItemWithAttributes:d];
+}
+
+
 @implementation RSHTMLMetadataParser
 
 #pragma mark - RSXMLParserDelegate
@@ -47,6 +304,22 @@
 	return YES;
 }
 
+- (BOOL)xmlParserHandledDataWithoutSAX:(NSData *)data {
+	if (!self.fastHeadScan) {
+		return NO;
+	}
+	self.fastScanFailed = NO;
+	if (scanHTMLHead(data.bytes, data.length, foundLinkTag, (__bridge void *)self) && !self.fastScanFailed) {
+		return YES;
+	}
+	self.fastScanFailed = YES;
+	// reset partial results and let libxml handle malformed markup
+	self.faviconLink = nil;
+	[self.iconLinks removeAllObjects];
+	[self.feedLinks removeAllObjects];
+	return NO;
+}
+
 - (id)xmlParserWillReturnDocument {
 	RSHTMLMetadata *metadata = [[RSHTMLMetadata alloc] init];
 	metadata.faviconLink = self.faviconLink;
@@ -26,6 +26,16 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+/// Fields that can be stored undecoded. See @c setRawCharacters:forField:baseURL:
+typedef NS_ENUM(NSUInteger, RSParsedArticleField) {
+	RSParsedArticleFieldTitle = 0,
+	RSParsedArticleFieldAbstract,
+	RSParsedArticleFieldBody,
+	RSParsedArticleFieldLink,
+	RSParsedArticleFieldDatePublished,
+	RSParsedArticleFieldDateModified,
+};
+
 /// Parsed result type for articles. Does contain article specific attributes like abstract and content.
 @interface RSParsedArticle : NSObject
 @property (nonatomic, readonly, nonnull) NSURL *feedURL;
@@ -46,6 +56,14 @@ NS_ASSUME_NONNULL_BEGIN
 - (nonnull instancetype)initWithFeedURL:(NSURL * _Nonnull)feedURL dateParsed:(NSDate*)parsed;
 ///Initiate calculation of article id. For optimization, call on a background thread after all properties have been set.
 - (void)calculateArticleID;
+/**
+ Keep UTF-8 characters of @c field and decode them on first access (thread-safe).
+ Text is trimmed and HTML entities are decoded, dates are parsed, and the link is resolved against @c baseURL.
+ Setting the property directly discards the raw characters.
+
+ @param data Will be retained, pass a copy if the bytes are not owned.
+ */
+- (void)setRawCharacters:(NSData *)data forField:(RSParsedArticleField)field baseURL:(nullable NSURL *)baseURL;
 
 @end
 
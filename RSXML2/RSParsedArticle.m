@@ -22,15 +22,30 @@
 //  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 //  SOFTWARE.
 
+#import <stdatomic.h>
 #import "RSParsedArticle.h"
+#import "RSDateParser.h"
 #import "NSString+RSXML.h"
 
 @interface RSParsedArticle()
 @property (nonatomic, copy) NSString *internalArticleID;
+- (void)decodeField:(RSParsedArticleField)field;
 @end
 
 
-@implementation RSParsedArticle
+@implementation RSParsedArticle {
+	_Atomic(NSUInteger) _pendingFields; // bit set = raw characters not decoded yet
+	NSURL *_baseURL;
+	NSData *_rawTitle;
+	NSData *_rawAbstract;
+	NSData *_rawBody;
+	NSData *_rawLink;
+	NSData *_rawDatePublished;
+	NSData *_rawDateModified;
+}
+
+@synthesize title = _title, abstract = _abstract, body = _body, link = _link;
+@synthesize datePublished = _datePublished, dateModified = _dateModified;
 
 - (instancetype)initWithFeedURL:(NSURL *)feedURL dateParsed:(NSDate*)parsed {
 	
@@ -44,6 +59,133 @@
 	return self;
 }
 
+#pragma mark - Lazy Decoding
+
+
+/// @return Ivar holding the raw characters of @c field.
+static NSData * __strong *rawSlot(RSParsedArticle *article, RSParsedArticleField field) {
+	switch (field) {
+		case RSParsedArticleFieldTitle:         return &article->_rawTitle;
+		case RSParsedArticleFieldAbstract:      return &article->_rawAbstract;
+		case RSParsedArticleFieldBody:          return &article->_rawBody;
+		case RSParsedArticleFieldLink:          return &article->_rawLink;
+		case RSParsedArticleFieldDatePublished: return &article->_rawDatePublished;
+		case RSParsedArticleFieldDateModified:  return &article->_rawDateModified;
+	}
+}
+
+/// Same result as @c currentStringWithTrimmedWhitespace of @c RSSAXParser.
+static NSString *trimmedString(NSData *data) {
+	if (data.length == 0) {
+		return nil;
+	}
+	NSString *str = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+	return [str stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
+}
+
+/// Fast path for all getters. Only takes the lock if @c field still needs decoding.
+static inline void decodeIfPending(RSParsedArticle *article, RSParsedArticleField field) {
+	if (atomic_load_explicit(&article->_pendingFields, memory_order_acquire) & (1u << field)) {
+		[article decodeField:field];
+	}
+}
+
+/// Setting a property replaces pending raw characters.
+static inline void discardRaw(RSParsedArticle *article, RSParsedArticleField field) {
+	if (atomic_fetch_and_explicit(&article->_pendingFields, ~(NSUInteger)(1u << field), memory_order_acq_rel) & (1u << field)) {
+		*rawSlot(article, field) = nil;
+	}
+}
+
+// docref in header
+- (void)setRawCharacters:(NSData *)data forField:(RSParsedArticleField)field baseURL:(NSURL *)baseURL {
+	*rawSlot(self, field) = data;
+	if (field == RSParsedArticleFieldLink) {
+		_baseURL = baseURL;
+	}
+	atomic_fetch_or_explicit(&_pendingFields, (NSUInteger)(1u << field), memory_order_release);
+}
+
+/// Decode raw characters of @c field and release them.
+- (void)decodeField:(RSParsedArticleField)field {
+	@synchronized (self) {
+		if ((atomic_load_explicit(&_pendingFields, memory_order_acquire) & (1u << field)) == 0) {
+			return; // decoded by another thread in the meantime
+		}
+		NSData * __strong *raw = rawSlot(self, field);
+		switch (field) {
+			case RSParsedArticleFieldTitle:         _title = [trimmedString(*raw) rsxml_stringByDecodingHTMLEntities]; break;
+			case RSParsedArticleFieldAbstract:      _abstract = [trimmedString(*raw) rsxml_stringByDecodingHTMLEntities]; break;
+			case RSParsedArticleFieldBody:          _body = [trimmedString(*raw) rsxml_stringByDecodingHTMLEntities]; break;
+			case RSParsedArticleFieldLink:          _link = [trimmedString(*raw) absoluteURLWithBase:_baseURL]; break;
+			case RSParsedArticleFieldDatePublished: _datePublished = RSDateWithBytes((*raw).bytes, (*raw).length); break;
+			case RSParsedArticleFieldDateModified:  _dateModified = RSDateWithBytes((*raw).bytes, (*raw).length); break;
+		}
+		*raw = nil;
+		atomic_fetch_and_explicit(&_pendingFields, ~(NSUInteger)(1u << field), memory_order_release);
+	}
+}
+
+- (NSString *)title {
+	decodeIfPending(self, RSParsedArticleFieldTitle);
+	return _title;
+}
+
+- (void)setTitle:(NSString *)title {
+	discardRaw(self, RSParsedArticleFieldTitle);
+	_title = title;
+}
+
+- (NSString *)abstract {
+	decodeIfPending(self, RSParsedArticleFieldAbstract);
+	return _abstract;
+}
+
+- (void)setAbstract:(NSString *)abstract {
+	discardRaw(self, RSParsedArticleFieldAbstract);
+	_abstract = abstract;
+}
+
+- (NSString *)body {
+	decodeIfPending(self, RSParsedArticleFieldBody);
+	return _body;
+}
+
+- (void)setBody:(NSString *)body {
+	discardRaw(self, RSParsedArticleFieldBody);
+	_body = body;
+}
+
+- (NSString *)link {
+	decodeIfPending(self, RSParsedArticleFieldLink);
+	return _link;
+}
+
+- (void)setLink:(NSString *)link {
+	discardRaw(self, RSParsedArticleFieldLink);
+	_link = link;
+}
+
+- (NSDate *)datePublished {
+	decodeIfPending(self, RSParsedArticleFieldDatePublished);
+	return _datePublished;
+}
+
+- (void)setDatePublished:(NSDate *)datePublished {
+	discardRaw(self, RSParsedArticleFieldDatePublished);
+	_datePublished = datePublished;
+}
+
+- (NSDate *)dateModified {
+	decodeIfPending(self, RSParsedArticleFieldDateModified);
+	return _dateModified;
+}
+
+- (void)setDateModified:(NSDate *)dateModified {
+	discardRaw(self, RSParsedArticleFieldDateModified);
+	_dateModified = dateModified;
+}
+
 #pragma mark - Unique Article ID
 
 // docref in header
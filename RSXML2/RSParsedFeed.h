@@ -39,6 +39,8 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, nullable) NSString *subtitle;
 
 - (nonnull instancetype)initWithURL:(NSURL * _Nonnull)url;
+/// Used to restore a previously parsed feed. @c initWithURL: sets @c dateParsed to now.
+- (nonnull instancetype)initWithURL:(NSURL * _Nonnull)url dateParsed:(NSDate * _Nonnull)dateParsed;
 /// Append new @c RSParsedArticle object to @c .articles and return newly inserted instance.
 - (RSParsedArticle *)appendNewArticle;
 
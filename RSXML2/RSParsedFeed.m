@@ -32,12 +32,17 @@
 @implementation RSParsedFeed
 
 - (instancetype)initWithURL:(NSURL *)url {
+	return [self initWithURL:url dateParsed:[NSDate date]];
+}
+
+// docref in header
+- (instancetype)initWithURL:(NSURL *)url dateParsed:(NSDate *)dateParsed {
 	
 	self = [super init];
 	if (self) {
 		_url = url;
 		_mutableArticles = [NSMutableArray new];
-		_dateParsed = [NSDate date];
+		_dateParsed = dateParsed;
 	}
 	return self;
 }
@@ -140,14 +140,14 @@ static NSString *kRDFAboutKey = @"rdf:about";
 		switch (len) {
 			case 4:
 				if (prefLen == 2 && EqualBytes(prefix, "dc", 2) && EqualBytes(localName, "date", 4))
-					self.currentArticle.datePublished = [self dateFromCharacters:SAXParser.currentCharacters];
+					[self setArticleField:RSParsedArticleFieldDatePublished fromSAXParser:SAXParser baseURL:nil];
 				return;
 			case 7:
 				if (prefLen == 2 && EqualBytes(prefix, "dc", 2) && EqualBytes(localName, "creator", 7)) {
 					self.currentArticle.author = SAXParser.currentStringWithTrimmedWhitespace;
 				}
 				else if (prefLen == 7 && EqualBytes(prefix, "content", 7) && EqualBytes(localName, "encoded", 7)) {
-					self.currentArticle.body = [self decodeHTMLEntities:SAXParser.currentStringWithTrimmedWhitespace];
+					[self setArticleField:RSParsedArticleFieldBody fromSAXParser:SAXParser baseURL:nil];
 				}
 				return;
 		}
@@ -158,7 +158,7 @@ static NSString *kRDFAboutKey = @"rdf:about";
 		switch (len) {
 			case 4:
 				if (EqualBytes(localName, "link", 4)) {
-					self.currentArticle.link = [SAXParser.currentStringWithTrimmedWhitespace absoluteURLWithBase:self.baseURL];
+					[self setArticleField:RSParsedArticleFieldLink fromSAXParser:SAXParser baseURL:self.baseURL];
 				}
 				else if (EqualBytes(localName, "guid", 4)) {
 					self.currentArticle.guid = SAXParser.currentStringWithTrimmedWhitespace;
@@ -169,7 +169,7 @@ static NSString *kRDFAboutKey = @"rdf:about";
 				return;
 			case 5:
 				if (EqualBytes(localName, "title", 5))
-					self.currentArticle.title = [self decodeHTMLEntities:SAXParser.currentStringWithTrimmedWhitespace];
+					[self setArticleField:RSParsedArticleFieldTitle fromSAXParser:SAXParser baseURL:nil];
 				return;
 			case 6:
 				if (EqualBytes(localName, "author", 6))
@@ -177,11 +177,11 @@ static NSString *kRDFAboutKey = @"rdf:about";
 				return;
 			case 7:
 				if (EqualBytes(localName, "pubDate", 7))
-					self.currentArticle.datePublished = [self dateFromCharacters:SAXParser.currentCharacters];
+					[self setArticleField:RSParsedArticleFieldDatePublished fromSAXParser:SAXParser baseURL:nil];
 				return;
 			case 11:
 				if (EqualBytes(localName, "description", 11))
-					self.currentArticle.abstract = [self decodeHTMLEntities:SAXParser.currentStringWithTrimmedWhitespace];
+					[self setArticleField:RSParsedArticleFieldAbstract fromSAXParser:SAXParser baseURL:nil];
 				return;
 		}
 	}
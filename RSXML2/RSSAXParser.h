@@ -34,7 +34,15 @@
  */
 
 
-@class RSSAXParser;
+@class RSSAXParser, RSXMLCancelToken;
+
+/// Reason why the parser stopped before reaching the end of the document.
+typedef NS_ENUM(NSInteger, RSSAXParserInterruption) {
+	RSSAXParserNotInterrupted = 0, // finished regularly or stopped via @c cancel
+	RSSAXParserCanceled,           // @c cancelToken was triggered
+	RSSAXParserTimedOut,           // @c timeout was exceeded
+	RSSAXParserTooManyErrors       // @c maxErrorCount was exceeded
+};
 
 /// Use @c xmlChar instead of @c unsigned @c char for all method parameters.
 @protocol RSSAXParserDelegate <NSObject>
@@ -61,16 +69,54 @@
 
 
 @interface RSSAXParser : NSObject
+/// First fatal @c libxml error of the last parse. Created on first access.
 @property (nonatomic, strong, readonly) NSError *parsingError;
+/// Number of errors (level @c XML_ERR_ERROR or higher) reported by @c libxml during the last parse.
+@property (nonatomic, assign, readonly) NSUInteger numberOfParsingErrors;
+/// The most recent (up to 64) errors of the last parse, oldest first. Created on each access.
+@property (nonatomic, copy, readonly) NSArray<NSError*> *allParsingErrors;
+/// Stop parsing once more than this many errors occurred. Default: @c 0 (no limit).
+@property (nonatomic, assign) NSUInteger maxErrorCount;
+/// Copy of the characters stored since @c beginStoringCharacters.
 @property (nonatomic, strong, readonly) NSData *currentCharacters;
+/// Same as @c currentCharacters but without copying. Valid until the current element ends.
+@property (nonatomic, strong, readonly) NSData *currentCharactersNoCopy;
 @property (nonatomic, strong, readonly) NSString *currentString;
 @property (nonatomic, strong, readonly) NSString *currentStringWithTrimmedWhitespace;
+/// Shared token to stop parsing from another thread. Polled between SAX events.
+@property (nonatomic, strong) RSXMLCancelToken *cancelToken;
+/// Time budget (in seconds) for a single @c parseBytes:numberOfBytes: call. Default: @c 0 (no limit).
+@property (nonatomic, assign) NSTimeInterval timeout;
+/// Default: @c NO. If @c YES, short attribute values and character strings are shared via @c RSXMLInternedString().
+@property (nonatomic, assign) BOOL internStrings;
+/**
+ Default: @c NO. If @c YES, @c libxml allocations and scratch buffers of each parse are served from
+ a private arena (see @c RSXMLArena.h) which is released in one step when parsing finishes.
+ Delegates must not keep @c libxml allocated memory beyond the parse.
+ */
+@property (nonatomic, assign) BOOL useArena;
+/// Peak arena size (in bytes) of the last parse. @c 0 if @c useArena is not set.
+@property (nonatomic, assign, readonly) NSUInteger memoryHighWaterMark;
+/// Will be set if the last parse was stopped by @c cancelToken, @c timeout or @c maxErrorCount. Reset with each parse.
+@property (nonatomic, assign, readonly) RSSAXParserInterruption interruption;
 
 - (instancetype)initWithDelegate:(id<RSSAXParserDelegate>)delegate;
 
 /// Initialize new xml or html parser context and start processing of data.
 - (void)parseBytes:(const void *)bytes numberOfBytes:(NSUInteger)numberOfBytes;
-/// Will stop the sax parser from processing any further. @c saxParserDidReachEndOfDocument: will not be called.
+/**
+ Incremental parsing. The first call creates a new parser context. The delegate is not retained between calls,
+ if it is gone the parse is abandoned.
+ After the last chunk all events are delivered, but the context (and @c libxml owned names) is kept until @c finishParsing.
+ */
+- (void)parseChunk:(const void *)bytes numberOfBytes:(NSUInteger)numberOfBytes isLastChunk:(BOOL)isLastChunk;
+/// Terminate the document (if needed) and free the parser context. Called by @c parseBytes:numberOfBytes: automatically.
+- (void)finishParsing;
+/**
+ Will stop the sax parser from processing any further. @c saxParserDidReachEndOfDocument: will not be called.
+ Thread-safe. The parser stops itself (on the parsing thread) before the next event is reported to the delegate.
+ Calls prior to @c parseBytes:numberOfBytes: are ignored, use @c cancelToken instead.
+ */
 - (void)cancel;
 /**
  Delegate can call from @c XMLStartElement.
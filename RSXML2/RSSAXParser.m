@@ -25,27 +25,87 @@
 #import <libxml/tree.h>
 #import <libxml/xmlstring.h>
 #import <libxml/parser.h>
+#import <stdatomic.h>
+#import <mach/mach_time.h>
 #import "RSSAXParser.h"
+#import "RSXMLCancelToken.h"
+#import "RSXMLInternPool.h"
+#import "RSXMLArena.h"
 
 const NSErrorDomain kLIBXMLParserErrorDomain = @"LIBXMLParserErrorDomain";
 
+/// Convert seconds to @c mach_absolute_time() units. Clamped, so that adding the current time can't overflow.
+static uint64_t machTimeFromInterval(NSTimeInterval seconds) {
+	static mach_timebase_info_data_t timebase;
+	static dispatch_once_t onceToken;
+	dispatch_once(&onceToken, ^{
+		mach_timebase_info(&timebase);
+	});
+	static const uint64_t maxTicks = UINT64_MAX / 2;
+	double ticks = seconds * NSEC_PER_SEC * timebase.denom / timebase.numer;
+	if (!(ticks < (double)maxTicks)) { // also catches inf
+		return maxTicks;
+	}
+	return (uint64_t)ticks;
+}
+
+/// Input is fed to libxml in chunks of this size. Each chunk has its own autorelease pool.
+static const NSUInteger kParseChunkSize = 64 * 1024;
+
+/// Number of error records kept per parse. Older records are overwritten, the total is still counted.
+#define kErrorRingSize 64
+
+/// Fixed-size copy of a @c libxml error. Converted to @c NSError only on request.
+typedef struct {
+	int code;
+	int line;
+	int column;
+} RSSAXParserErrorRecord;
+
+// Delegate method implementations, looked up once in initWithDelegate:
+typedef void (*RSStartElementIMP)(id, SEL, RSSAXParser *, const xmlChar *, const xmlChar *, const xmlChar *, NSInteger, const xmlChar **, NSInteger, int, const xmlChar **);
+typedef void (*RSStartHTMLElementIMP)(id, SEL, RSSAXParser *, const xmlChar *, const xmlChar **);
+typedef void (*RSEndElementIMP)(id, SEL, RSSAXParser *, const xmlChar *, const xmlChar *, const xmlChar *);
+typedef void (*RSEndHTMLElementIMP)(id, SEL, RSSAXParser *, const xmlChar *);
+typedef void (*RSCharactersFoundIMP)(id, SEL, RSSAXParser *, const xmlChar *, NSUInteger);
+typedef void (*RSEndOfDocumentIMP)(id, SEL, RSSAXParser *);
+typedef NSString *(*RSInternedNameIMP)(id, SEL, RSSAXParser *, const xmlChar *, const xmlChar *);
+typedef NSString *(*RSInternedValueIMP)(id, SEL, RSSAXParser *, const void *, NSUInteger);
+
 
 @interface RSSAXParser ()
 @property (nonatomic, weak) id<RSSAXParserDelegate> delegate;
 @property (nonatomic, assign) xmlParserCtxtPtr context;
 @property (nonatomic, assign) BOOL storingCharacters;
-@property (nonatomic) NSMutableData *characters;
 @property (nonatomic, assign) BOOL isHTMLParser;
-@property (nonatomic, assign) BOOL delegateRespondsToInternedStringMethod;
-@property (nonatomic, assign) BOOL delegateRespondsToInternedStringForValueMethod;
-@property (nonatomic, assign) BOOL delegateRespondsToStartElementMethod;
-@property (nonatomic, assign) BOOL delegateRespondsToEndElementMethod;
-@property (nonatomic, assign) BOOL delegateRespondsToCharactersFoundMethod;
-@property (nonatomic, assign) BOOL delegateRespondsToEndOfDocumentMethod;
 @end
 
 
-@implementation RSSAXParser
+@implementation RSSAXParser {
+	atomic_bool _stopRequested;
+	BOOL _stopped;
+	uint64_t _deadline; // mach_absolute_time(), 0 = no limit
+	NSUInteger _eventCount;
+	NSError *_parsingError; // created lazily from _firstFatalError
+	RSSAXParserErrorRecord _firstFatalError; // code 0 = none
+	char _firstFatalErrorMessage[256];
+	RSSAXParserErrorRecord _errorRing[kErrorRingSize];
+	NSUInteger _errorCount;
+	BOOL _terminated; // final chunk was parsed, context is still alive
+	RSXMLArena *_arena;
+	char *_characterBuffer; // reused for all elements of a parse
+	NSUInteger _characterBufferLength;
+	NSUInteger _characterBufferCapacity;
+	__unsafe_unretained id _currentDelegate; // set while libxml runs, strong reference is held by the caller
+	RSStartElementIMP _startElementIMP;
+	RSStartHTMLElementIMP _startHTMLElementIMP;
+	RSEndElementIMP _endElementIMP;
+	RSEndHTMLElementIMP _endHTMLElementIMP;
+	RSCharactersFoundIMP _charactersFoundIMP;
+	RSEndOfDocumentIMP _endOfDocumentIMP;
+	RSInternedNameIMP _internedNameIMP;
+	RSInternedValueIMP _internedValueIMP;
+}
 
 + (void)initialize {
 	static dispatch_once_t onceToken;
@@ -63,28 +123,38 @@ const NSErrorDomain kLIBXMLParserErrorDomain = @"LIBXMLParserErrorDomain";
 		return nil;
 
 	_delegate = delegate;
-	_delegateRespondsToCharactersFoundMethod = [_delegate respondsToSelector:@selector(saxParser:XMLCharactersFound:length:)];
-	_delegateRespondsToEndOfDocumentMethod = [_delegate respondsToSelector:@selector(saxParserDidReachEndOfDocument:)];
-	_delegateRespondsToInternedStringMethod = [_delegate respondsToSelector:@selector(saxParser:internedStringForName:prefix:)];
-	_delegateRespondsToInternedStringForValueMethod = [_delegate respondsToSelector:@selector(saxParser:internedStringForValue:length:)];
+	_charactersFoundIMP = (RSCharactersFoundIMP)[self delegateIMP:@selector(saxParser:XMLCharactersFound:length:)];
+	_endOfDocumentIMP = (RSEndOfDocumentIMP)[self delegateIMP:@selector(saxParserDidReachEndOfDocument:)];
+	_internedNameIMP = (RSInternedNameIMP)[self delegateIMP:@selector(saxParser:internedStringForName:prefix:)];
+	_internedValueIMP = (RSInternedValueIMP)[self delegateIMP:@selector(saxParser:internedStringForValue:length:)];
 	
 	if ([[_delegate class] respondsToSelector:@selector(isHTMLParser)] && [[_delegate class] isHTMLParser]) {
 		_isHTMLParser = YES;
-		_delegateRespondsToStartElementMethod = [_delegate respondsToSelector:@selector(saxParser:XMLStartElement:attributes:)];
-		_delegateRespondsToEndElementMethod = [_delegate respondsToSelector:@selector(saxParser:XMLEndElement:)];
+		_startHTMLElementIMP = (RSStartHTMLElementIMP)[self delegateIMP:@selector(saxParser:XMLStartElement:attributes:)];
+		_endHTMLElementIMP = (RSEndHTMLElementIMP)[self delegateIMP:@selector(saxParser:XMLEndElement:)];
 	} else {
-		_delegateRespondsToStartElementMethod = [_delegate respondsToSelector:@selector(saxParser:XMLStartElement:prefix:uri:numberOfNamespaces:namespaces:numberOfAttributes:numberDefaulted:attributes:)];
-		_delegateRespondsToEndElementMethod = [_delegate respondsToSelector:@selector(saxParser:XMLEndElement:prefix:uri:)];
+		_startElementIMP = (RSStartElementIMP)[self delegateIMP:@selector(saxParser:XMLStartElement:prefix:uri:numberOfNamespaces:namespaces:numberOfAttributes:numberDefaulted:attributes:)];
+		_endElementIMP = (RSEndElementIMP)[self delegateIMP:@selector(saxParser:XMLEndElement:prefix:uri:)];
 	}
 
 	return self;
 }
 
-- (void)dealloc {
-	if (_context != nil) {
-		xmlFreeParserCtxt(_context);
-		_context = nil;
+/**
+ Libxml callbacks call the delegate through these function pointers directly, instead of going
+ through @c objc_msgSend and the @c weak delegate property for each event.
+
+ @return Method implementation or @c NULL if the delegate doesn't implement @c selector.
+ */
+- (IMP)delegateIMP:(SEL)selector {
+	if (![_delegate respondsToSelector:selector]) {
+		return NULL;
 	}
+	return [(NSObject *)_delegate methodForSelector:selector];
+}
+
+- (void)dealloc {
+	[self freeParsingResources];
 	_delegate = nil;
 }
 
@@ -94,72 +164,190 @@ const NSErrorDomain kLIBXMLParserErrorDomain = @"LIBXMLParserErrorDomain";
 
 static xmlSAXHandler saxHandlerStruct;
 
+/// Route libxml allocations to the arena of the current parse (if any). @return Pass to @c leaveArena().
+static inline RSXMLArena *enterArena(RSSAXParser *parser) {
+	return (parser->_arena ? RSXMLArenaSetCurrent(parser->_arena) : NULL);
+}
+
+static inline void leaveArena(RSSAXParser *parser, RSXMLArena *previous) {
+	if (parser->_arena) {
+		RSXMLArenaSetCurrent(previous);
+	}
+}
+
 // docref in header
 - (void)parseBytes:(const void *)bytes numberOfBytes:(NSUInteger)numberOfBytes {
+	[self parseChunk:bytes numberOfBytes:numberOfBytes isLastChunk:NO];
+	[self finishParsing];
+}
 
+// docref in header
+- (void)parseChunk:(const void *)bytes numberOfBytes:(NSUInteger)numberOfBytes isLastChunk:(BOOL)isLastChunk {
+	if (self.context == nil && ![self startParsing:bytes numberOfBytes:numberOfBytes]) {
+		return;
+	}
+	if (_stopped || _terminated) {
+		return;
+	}
+	// Strong only for this call. Keeping it between chunks would retain delegates that own the parser.
+	NS_VALID_UNTIL_END_OF_SCOPE id<RSSAXParserDelegate> delegate = self.delegate;
+	if (!delegate) {
+		[self freeParsingResources];
+		return;
+	}
+	_currentDelegate = delegate;
+	RSXMLArena *previous = enterArena(self);
+	const char *chunk = bytes;
+	NSUInteger remaining = numberOfBytes;
+	do {
+		@autoreleasepool { // one pool per chunk, instead of one per callback
+			int length = (int)MIN(remaining, kParseChunkSize);
+			remaining -= (NSUInteger)length;
+			int terminate = (isLastChunk && remaining == 0);
+			if (self.isHTMLParser) {
+				htmlParseChunk(self.context, chunk, length, terminate);
+			} else {
+				xmlParseChunk(self.context, chunk, length, terminate);
+			}
+			chunk += length;
+		}
+	} while (remaining > 0 && !_stopped);
+	_terminated = (isLastChunk && remaining == 0);
+	leaveArena(self, previous);
+	_currentDelegate = nil;
+}
+
+/**
+ Reset state of previous parse and create a new @c libxml context.
+ @return @c NO if parsing should not start at all (canceled or no delegate).
+ */
+- (BOOL)startParsing:(const void *)bytes numberOfBytes:(NSUInteger)numberOfBytes {
 	_parsingError = nil;
+	_firstFatalError.code = 0;
+	_firstFatalErrorMessage[0] = '\0';
+	_errorCount = 0;
+	_interruption = RSSAXParserNotInterrupted;
+	_stopped = NO;
+	_terminated = NO;
+	_eventCount = 0;
+	_memoryHighWaterMark = 0;
+	_deadline = (self.timeout > 0 ? mach_absolute_time() + machTimeFromInterval(self.timeout) : 0);
+	atomic_store_explicit(&_stopRequested, false, memory_order_relaxed);
+
+	if (self.cancelToken.isCanceled) {
+		_interruption = RSSAXParserCanceled;
+		return NO;
+	}
+	if (!self.delegate) {
+		return NO;
+	}
+	if (self.useArena) {
+		_arena = RSXMLArenaCreate(0);
+	}
+	RSXMLArena *previous = enterArena(self);
+	if (self.isHTMLParser) {
+		xmlCharEncoding characterEncoding = xmlDetectCharEncoding(bytes, (int)MIN(numberOfBytes, kParseChunkSize));
+		self.context = htmlCreatePushParserCtxt(&saxHandlerStruct, (__bridge void *)self, nil, 0, nil, characterEncoding);
+		htmlCtxtUseOptions(self.context, XML_PARSE_RECOVER | XML_PARSE_NONET | HTML_PARSE_COMPACT);
+	} else {
+		self.context = xmlCreatePushParserCtxt(&saxHandlerStruct, (__bridge void *)self, nil, 0, nil);
+		xmlCtxtUseOptions(self.context, XML_PARSE_RECOVER | XML_PARSE_NOENT);
+	}
+	leaveArena(self, previous);
+	return YES;
+}
 
+// docref in header
+- (void)finishParsing {
 	if (self.context == nil) {
-		if (self.isHTMLParser) {
-			xmlCharEncoding characterEncoding = xmlDetectCharEncoding(bytes, (int)numberOfBytes);
-			self.context = htmlCreatePushParserCtxt(&saxHandlerStruct, (__bridge void *)self, nil, 0, nil, characterEncoding);
-			htmlCtxtUseOptions(self.context, XML_PARSE_RECOVER | XML_PARSE_NONET | HTML_PARSE_COMPACT);
-		} else {
-			self.context = xmlCreatePushParserCtxt(&saxHandlerStruct, (__bridge void *)self, nil, 0, nil);
-			xmlCtxtUseOptions(self.context, XML_PARSE_RECOVER | XML_PARSE_NOENT);
+		return;
+	}
+	NS_VALID_UNTIL_END_OF_SCOPE id<RSSAXParserDelegate> delegate = self.delegate;
+	if (!_terminated && delegate) { // no delegate, no need to report the remaining events
+		_currentDelegate = delegate;
+		RSXMLArena *previous = enterArena(self);
+		@autoreleasepool {
+			if (self.isHTMLParser) {
+				htmlParseChunk(self.context, nil, 0, 1);
+			} else {
+				xmlParseChunk(self.context, nil, 0, 1);
+			}
 		}
+		leaveArena(self, previous);
 	}
+	[self freeParsingResources];
+}
 
-	@autoreleasepool {
+/// Free @c libxml context, character buffer and arena. Does not notify the delegate.
+- (void)freeParsingResources {
+	RSXMLArena *previous = enterArena(self);
+	if (_context != nil) {
 		if (self.isHTMLParser) {
-			htmlParseChunk(self.context, (const char *)bytes, (int)numberOfBytes, 0);
+			htmlFreeParserCtxt(_context);
 		} else {
-			xmlParseChunk(self.context, (const char *)bytes, (int)numberOfBytes, 0);
+			xmlFreeParserCtxt(_context);
 		}
+		_context = nil;
 	}
+	RSXMLArenaFree(_arena, _characterBuffer);
+	_characterBuffer = NULL;
+	_characterBufferLength = _characterBufferCapacity = 0;
+	_storingCharacters = NO;
+	_currentDelegate = nil;
 	
-	[self finishParsing];
+	if (_arena) {
+		xmlResetLastError(); // error message may be arena memory
+		leaveArena(self, previous);
+		_memoryHighWaterMark = RSXMLArenaHighWaterMark(_arena);
+		RSXMLArenaDestroy(_arena);
+		_arena = NULL;
+	}
 }
 
-/**
- Call after @c parseData: or @c parseBytes:numberOfBytes:
- */
-- (void)finishParsing {
+// docref in header
+- (NSError *)parsingError {
+	if (!_parsingError && _firstFatalError.code != 0) {
+		NSString *msg = [[NSString stringWithUTF8String:_firstFatalErrorMessage] stringByTrimmingCharactersInSet:
+						 [NSCharacterSet whitespaceAndNewlineCharacterSet]];
+		_parsingError = [NSError errorWithDomain:kLIBXMLParserErrorDomain code:_firstFatalError.code
+										userInfo:@{ NSLocalizedDescriptionKey: msg ?: @"" }];
+	}
+	return _parsingError;
+}
 
-	NSAssert(self.context != nil, nil);
-	if (self.context == nil)
-		return;
+// docref in header
+- (NSUInteger)numberOfParsingErrors {
+	return _errorCount;
+}
 
-	@autoreleasepool {
-		if (self.isHTMLParser) {
-			htmlParseChunk(self.context, nil, 0, 1);
-			htmlFreeParserCtxt(self.context);
-		} else {
-			xmlParseChunk(self.context, nil, 0, 1);
-			xmlFreeParserCtxt(self.context);
-		}
-		self.context = nil;
-		self.characters = nil;
+// docref in header
+- (NSArray<NSError*> *)allParsingErrors {
+	NSUInteger count = MIN(_errorCount, (NSUInteger)kErrorRingSize);
+	NSMutableArray<NSError*> *errors = [NSMutableArray arrayWithCapacity:count];
+	for (NSUInteger i = _errorCount - count; i < _errorCount; i++) {
+		RSSAXParserErrorRecord rec = _errorRing[i % kErrorRingSize];
+		NSString *msg = [NSString stringWithFormat:@"line %d, column %d: libxml error %d", rec.line, rec.column, rec.code];
+		[errors addObject:[NSError errorWithDomain:kLIBXMLParserErrorDomain code:rec.code
+										  userInfo:@{ NSLocalizedDescriptionKey: msg }]];
 	}
+	return errors;
 }
 
 // docref in header
 - (void)cancel {
-	@autoreleasepool {
-		xmlStopParser(self.context);
-	}
+	atomic_store_explicit(&_stopRequested, true, memory_order_relaxed);
 }
 
 // docref in header
 - (void)beginStoringCharacters {
 	self.storingCharacters = YES;
-	self.characters = [NSMutableData new];
+	_characterBufferLength = 0;
 }
 
 /// Will be called after each closing tag and the document end.
 - (void)endStoringCharacters {
 	self.storingCharacters = NO;
-	self.characters = nil;
+	_characterBufferLength = 0;
 }
 
 /// @return @c nil if not storing characters. UTF-8 encoded.
@@ -167,23 +355,71 @@ static xmlSAXHandler saxHandlerStruct;
 	if (!self.storingCharacters) {
 		return nil;
 	}
-	return self.characters;
+	return [NSData dataWithBytes:_characterBuffer length:_characterBufferLength];
+}
+
+/// @return @c nil if not storing characters. UTF-8 encoded. Points into the character buffer, see header.
+- (NSData *)currentCharactersNoCopy {
+	if (!self.storingCharacters) {
+		return nil;
+	}
+	if (_characterBufferLength == 0) {
+		return [NSData data];
+	}
+	return [NSData dataWithBytesNoCopy:_characterBuffer length:_characterBufferLength freeWhenDone:NO];
 }
 
 /// Convenience method to get string version of @c currentCharacters.
 - (NSString *)currentString {
-	NSData *d = self.currentCharacters;
+	NSData *d = self.currentCharactersNoCopy;
 	if (!d || d.length == 0) {
 		return nil;
 	}
+	if (self.internStrings && d.length <= RSXMLInternPoolMaxLength) {
+		NSString *interned = RSXMLInternedString(d.bytes, d.length);
+		if (interned) {
+			return interned;
+		}
+	}
 	return [[NSString alloc] initWithData:d encoding:NSUTF8StringEncoding];
 }
 
 /// Trim whitespace and newline characters from @c currentString.
 - (NSString *)currentStringWithTrimmedWhitespace {
+	if (self.internStrings) {
+		NSString *interned = [self currentStringInternedWithTrimmedWhitespace];
+		if (interned) {
+			return interned;
+		}
+	}
 	return [self.currentString stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
 }
 
+/**
+ Trim ASCII whitespace directly on the bytes and look up the result in the intern pool.
+ @return @c nil if there are no characters, the result is too long, or it begins or ends with a
+ control or non-ASCII character (which could be whitespace too, use the @c NSCharacterSet path then).
+ */
+- (NSString *)currentStringInternedWithTrimmedWhitespace {
+	NSData *d = self.currentCharactersNoCopy;
+	if (!d || d.length == 0) {
+		return nil;
+	}
+	const unsigned char *start = d.bytes;
+	const unsigned char *end = start + d.length;
+	while (start < end && (*start == ' ' || *start == '\t' || *start == '\n' || *start == '\r')) {
+		start++;
+	}
+	while (end > start && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\n' || end[-1] == '\r')) {
+		end--;
+	}
+	NSUInteger length = (NSUInteger)(end - start);
+	if (length == 0 || length > RSXMLInternPoolMaxLength || *start <= 0x20 || *start >= 0x80 || end[-1] <= 0x20 || end[-1] >= 0x80) {
+		return nil;
+	}
+	return RSXMLInternedString(start, length);
+}
+
 
 #pragma mark - Attributes Dictionary
 
@@ -197,36 +433,40 @@ static xmlSAXHandler saxHandlerStruct;
 
 	NSMutableDictionary *d = [NSMutableDictionary new];
 
-	@autoreleasepool {
-		for (NSInteger i = 0, j = 0; i < numberOfAttributes; i++, j+=5) {
+	for (NSInteger i = 0, j = 0; i < numberOfAttributes; i++, j+=5) {
 
-			NSUInteger lenValue = (NSUInteger)(attributes[j + 4] - attributes[j + 3]);
-			NSString *value = nil;
+		NSUInteger lenValue = (NSUInteger)(attributes[j + 4] - attributes[j + 3]);
+		NSString *value = nil;
 
-			if (self.delegateRespondsToInternedStringForValueMethod) {
-				value = [self.delegate saxParser:self internedStringForValue:(const void *)attributes[j + 3] length:lenValue];
-			}
-			if (!value) {
-				value = [[NSString alloc] initWithBytes:(const void *)attributes[j + 3] length:lenValue encoding:NSUTF8StringEncoding];
-			}
+		if (_internedValueIMP && _currentDelegate) {
+			value = _internedValueIMP(_currentDelegate, @selector(saxParser:internedStringForValue:length:), self, (const void *)attributes[j + 3], lenValue);
+		}
+		if (!value && self.internStrings) {
+			value = RSXMLInternedString((const void *)attributes[j + 3], lenValue);
+		}
+		if (!value) {
+			value = [[NSString alloc] initWithBytes:(const void *)attributes[j + 3] length:lenValue encoding:NSUTF8StringEncoding];
+		}
 
-			NSString *attributeName = nil;
+		NSString *attributeName = nil;
 
-			if (self.delegateRespondsToInternedStringMethod) {
-				attributeName = [self.delegate saxParser:self internedStringForName:(const xmlChar *)attributes[j] prefix:(const xmlChar *)attributes[j + 1]];
-			}
+		if (_internedNameIMP && _currentDelegate) {
+			attributeName = _internedNameIMP(_currentDelegate, @selector(saxParser:internedStringForName:prefix:), self, (const xmlChar *)attributes[j], (const xmlChar *)attributes[j + 1]);
+		}
 
-			if (!attributeName) {
-				attributeName = [NSString stringWithUTF8String:(const char *)attributes[j]];
-				if (attributes[j + 1]) {
-					NSString *attributePrefix = [NSString stringWithUTF8String:(const char *)attributes[j + 1]];
-					attributeName = [NSString stringWithFormat:@"%@:%@", attributePrefix, attributeName];
-				}
+		if (!attributeName && self.internStrings && !attributes[j + 1]) {
+			attributeName = RSXMLInternedString(attributes[j], (NSUInteger)xmlStrlen(attributes[j]));
+		}
+		if (!attributeName) {
+			attributeName = [NSString stringWithUTF8String:(const char *)attributes[j]];
+			if (attributes[j + 1]) {
+				NSString *attributePrefix = [NSString stringWithUTF8String:(const char *)attributes[j + 1]];
+				attributeName = [NSString stringWithFormat:@"%@:%@", attributePrefix, attributeName];
 			}
+		}
 
-			if (value && attributeName) {
-				d[attributeName] = value;
-			}
+		if (value && attributeName) {
+			d[attributeName] = value;
 		}
 	}
 	return d;
@@ -251,12 +491,12 @@ static xmlSAXHandler saxHandlerStruct;
 			break;
 		}
 		if (!currentKey) {
-			currentKey = [NSString stringWithUTF8String:(const char *)oneAttribute];
+			currentKey = [self stringWithUTF8String:oneAttribute];
 		}
 		else {
 			NSString *value = nil;
 			if (oneAttribute) {
-				value = [NSString stringWithUTF8String:(const char *)oneAttribute];
+				value = [self stringWithUTF8String:oneAttribute];
 			}
 			d[currentKey] = (value ? value : @"");
 			currentKey = nil;
@@ -266,122 +506,167 @@ static xmlSAXHandler saxHandlerStruct;
 }
 
 
-#pragma mark - Callbacks
-
-
-- (void)xmlEndDocument {
-
-	@autoreleasepool {
-		if (self.delegateRespondsToEndOfDocumentMethod) {
-			[self.delegate saxParserDidReachEndOfDocument:self];
+/// @return Interned string if @c internStrings is set and the string is short enough. New string otherwise.
+- (NSString *)stringWithUTF8String:(const xmlChar *)str {
+	if (self.internStrings) {
+		NSString *interned = RSXMLInternedString(str, (NSUInteger)xmlStrlen(str));
+		if (interned) {
+			return interned;
 		}
-
-		[self endStoringCharacters];
 	}
+	return [NSString stringWithUTF8String:(const char *)str];
 }
 
 
-- (void)xmlCharactersFound:(const xmlChar *)ch length:(NSUInteger)length {
-
-	@autoreleasepool {
-		if (self.storingCharacters) {
-			[self.characters appendBytes:(const void *)ch length:length];
-		}
-
-		if (self.delegateRespondsToCharactersFoundMethod) {
-			[self.delegate saxParser:self XMLCharactersFound:ch length:length];
-		}
-	}
-}
+#pragma mark - Callbacks
 
 
-- (void)xmlStartElement:(const xmlChar *)localName prefix:(const xmlChar *)prefix uri:(const xmlChar *)uri numberOfNamespaces:(int)numberOfNamespaces namespaces:(const xmlChar **)namespaces numberOfAttributes:(int)numberOfAttributes numberDefaulted:(int)numberDefaulted attributes:(const xmlChar **)attributes {
+/*
+ The libxml callbacks below are plain C functions with direct ivar access. They are hot paths:
+ no message sends except the cached delegate IMPs, and no per-event autorelease pools
+ (see the chunked loop in parseBytes:numberOfBytes:).
+ */
 
-	if (self.delegateRespondsToStartElementMethod) {
-		@autoreleasepool {
-			[self.delegate saxParser:self XMLStartElement:localName prefix:prefix uri:uri numberOfNamespaces:numberOfNamespaces namespaces:namespaces numberOfAttributes:numberOfAttributes numberDefaulted:numberDefaulted attributes:attributes];
-		}
-	}
+/// Halt libxml. Safe because it is only called on the parsing thread while @c context is alive.
+static inline void stopParsing(RSSAXParser *parser, RSSAXParserInterruption reason) {
+	parser->_stopped = YES;
+	parser->_interruption = reason;
+	xmlStopParser(parser->_context);
 }
 
+/**
+ Stops the parser if @c cancel was called, the @c cancelToken was triggered, or the time
+ budget is exhausted. The cancel flag is checked on every event, token and clock only every 32 events.
 
-- (void)xmlStartHTMLElement:(const xmlChar *)localName attributes:(const xmlChar **)attributes {
-
-	if (self.delegateRespondsToStartElementMethod) {
-		@autoreleasepool {
-			[self.delegate saxParser:self XMLStartElement:localName attributes:attributes];
+ @return @c YES if the event should not be forwarded to the delegate.
+ */
+static inline BOOL shouldStopParsing(RSSAXParser *parser) {
+	if (parser->_stopped) {
+		return YES;
+	}
+	if (atomic_load_explicit(&parser->_stopRequested, memory_order_relaxed)) {
+		stopParsing(parser, RSSAXParserNotInterrupted);
+	}
+	else if ((++parser->_eventCount & 31) == 0) {
+		if (parser->_cancelToken.isCanceled) {
+			stopParsing(parser, RSSAXParserCanceled);
+		} else if (parser->_deadline > 0 && mach_absolute_time() > parser->_deadline) {
+			stopParsing(parser, RSSAXParserTimedOut);
 		}
 	}
+	return parser->_stopped;
 }
 
-
-- (void)xmlEndElement:(const xmlChar *)localName prefix:(const xmlChar *)prefix uri:(const xmlChar *)uri {
-
-	@autoreleasepool {
-		if (self.delegateRespondsToEndElementMethod) {
-			[self.delegate saxParser:self XMLEndElement:localName prefix:prefix uri:uri];
+/// Grow character buffer (arena backed if enabled) and append @c length bytes.
+static void appendCharacters(RSSAXParser *parser, const xmlChar *ch, NSUInteger length) {
+	NSUInteger needed = parser->_characterBufferLength + length;
+	if (needed > parser->_characterBufferCapacity) {
+		NSUInteger capacity = MAX(needed, MAX(parser->_characterBufferCapacity * 2, 256u));
+		char *buffer = RSXMLArenaRealloc(parser->_arena, parser->_characterBuffer, capacity);
+		if (!buffer) {
+			return;
 		}
-		[self endStoringCharacters];
+		parser->_characterBuffer = buffer;
+		parser->_characterBufferCapacity = capacity;
 	}
+	memcpy(parser->_characterBuffer + parser->_characterBufferLength, ch, length);
+	parser->_characterBufferLength = needed;
 }
 
-
-- (void)xmlEndHTMLElement:(const xmlChar *)localName {
-
-	@autoreleasepool {
-		if (self.delegateRespondsToEndElementMethod) {
-			[self.delegate saxParser:self XMLEndElement:localName];
-		}
-		[self endStoringCharacters];
+static void endDocumentSAX(void *context) {
+	__unsafe_unretained RSSAXParser *parser = (__bridge RSSAXParser *)context;
+	if (shouldStopParsing(parser)) {
+		return;
 	}
+	if (parser->_cancelToken.isCanceled) { // don't wait for the next poll, this is the last event
+		stopParsing(parser, RSSAXParserCanceled);
+		return;
+	}
+	if (parser->_endOfDocumentIMP) {
+		parser->_endOfDocumentIMP(parser->_currentDelegate, @selector(saxParserDidReachEndOfDocument:), parser);
+	}
+	[parser endStoringCharacters];
 }
 
-- (void)xmlParsingErrorOccured:(NSError*)error {
-	if (!self.parsingError) // grep first encountered error
-		_parsingError = error;
+static void charactersFoundSAX(void *context, const xmlChar *ch, int len) {
+	__unsafe_unretained RSSAXParser *parser = (__bridge RSSAXParser *)context;
+	if (shouldStopParsing(parser)) {
+		return;
+	}
+	if (parser->_storingCharacters) {
+		appendCharacters(parser, ch, (NSUInteger)len);
+	}
+	if (parser->_charactersFoundIMP) {
+		parser->_charactersFoundIMP(parser->_currentDelegate, @selector(saxParser:XMLCharactersFound:length:), parser, ch, (NSUInteger)len);
+	}
 }
 
-@end
-
-
 static void startElementSAX(void *context, const xmlChar *localname, const xmlChar *prefix, const xmlChar *URI, int nb_namespaces, const xmlChar **namespaces, int nb_attributes, int nb_defaulted, const xmlChar **attributes) {
-	[(__bridge RSSAXParser *)context xmlStartElement:localname prefix:prefix uri:URI numberOfNamespaces:nb_namespaces namespaces:namespaces numberOfAttributes:nb_attributes numberDefaulted:nb_defaulted attributes:attributes];
-}
-
-static void	endElementSAX(void *context, const xmlChar *localname, const xmlChar *prefix, const xmlChar *URI) {
-	[(__bridge RSSAXParser *)context xmlEndElement:localname prefix:prefix uri:URI];
-}
-
-static void	charactersFoundSAX(void *context, const xmlChar *ch, int len) {
-	[(__bridge RSSAXParser *)context xmlCharactersFound:ch length:(NSUInteger)len];
+	__unsafe_unretained RSSAXParser *parser = (__bridge RSSAXParser *)context;
+	if (shouldStopParsing(parser)) {
+		return;
+	}
+	if (parser->_startElementIMP) {
+		parser->_startElementIMP(parser->_currentDelegate, @selector(saxParser:XMLStartElement:prefix:uri:numberOfNamespaces:namespaces:numberOfAttributes:numberDefaulted:attributes:), parser, localname, prefix, URI, nb_namespaces, namespaces, nb_attributes, nb_defaulted, attributes);
+	}
 }
 
-static void endDocumentSAX(void *context) {
-	[(__bridge RSSAXParser *)context xmlEndDocument];
+static void startElementSAX_HTML(void *context, const xmlChar *localname, const xmlChar **attributes) {
+	__unsafe_unretained RSSAXParser *parser = (__bridge RSSAXParser *)context;
+	if (shouldStopParsing(parser)) {
+		return;
+	}
+	if (parser->_startHTMLElementIMP) {
+		parser->_startHTMLElementIMP(parser->_currentDelegate, @selector(saxParser:XMLStartElement:attributes:), parser, localname, attributes);
+	}
 }
 
-static void startElementSAX_HTML(void *context, const xmlChar *localname, const xmlChar **attributes) {
-	[(__bridge RSSAXParser *)context xmlStartHTMLElement:localname attributes:attributes];
+static void endElementSAX(void *context, const xmlChar *localname, const xmlChar *prefix, const xmlChar *URI) {
+	__unsafe_unretained RSSAXParser *parser = (__bridge RSSAXParser *)context;
+	if (shouldStopParsing(parser)) {
+		return;
+	}
+	if (parser->_endElementIMP) {
+		parser->_endElementIMP(parser->_currentDelegate, @selector(saxParser:XMLEndElement:prefix:uri:), parser, localname, prefix, URI);
+	}
+	[parser endStoringCharacters];
 }
 
-static void	endElementSAX_HTML(void *context, const xmlChar *localname) {
-	[(__bridge RSSAXParser *)context xmlEndHTMLElement:localname];
+static void endElementSAX_HTML(void *context, const xmlChar *localname) {
+	__unsafe_unretained RSSAXParser *parser = (__bridge RSSAXParser *)context;
+	if (shouldStopParsing(parser)) {
+		return;
+	}
+	if (parser->_endHTMLElementIMP) {
+		parser->_endHTMLElementIMP(parser->_currentDelegate, @selector(saxParser:XMLEndElement:), parser, localname);
+	}
+	[parser endStoringCharacters];
 }
 
-static void errorOccuredSAX(void *context, const char *format, ...) {
-	xmlErrorPtr err = xmlGetLastError();
-	if (err && err->level == XML_ERR_FATAL) {
-		int errCode = err->code;
-		char * msg = err->message;
-		NSString *errMsg = [[NSString stringWithFormat:@"%s", msg] stringByTrimmingCharactersInSet:
-							[NSCharacterSet whitespaceAndNewlineCharacterSet]];
-		NSError *error = [NSError errorWithDomain:kLIBXMLParserErrorDomain code:errCode
-										 userInfo:@{ NSLocalizedDescriptionKey: errMsg }];
-		[(__bridge RSSAXParser *)context xmlParsingErrorOccured:error];
+/**
+ Structured error handler. Copies code and position into the error ring, the message only for the
+ first fatal error. No Objective-C objects are created, see @c parsingError and @c allParsingErrors.
+ */
+static void structuredErrorSAX(void *context, const xmlError *err) {
+	__unsafe_unretained RSSAXParser *parser = (__bridge RSSAXParser *)context;
+	if (!err || err->level < XML_ERR_ERROR) {
+		return; // ignore warnings
+	}
+	RSSAXParserErrorRecord rec = { err->code, err->line, err->int2 };
+	parser->_errorRing[parser->_errorCount % kErrorRingSize] = rec;
+	parser->_errorCount += 1;
+	
+	if (err->level == XML_ERR_FATAL && parser->_firstFatalError.code == 0) { // grep first encountered error
+		parser->_firstFatalError = rec;
+		strlcpy(parser->_firstFatalErrorMessage, err->message ? err->message : "", sizeof(parser->_firstFatalErrorMessage));
+	}
+	if (parser->_maxErrorCount > 0 && parser->_errorCount > parser->_maxErrorCount && !parser->_stopped) {
+		stopParsing(parser, RSSAXParserTooManyErrors);
 	}
-	xmlResetLastError();
 }
 
+@end
+
 
 static xmlSAXHandler saxHandlerStruct = {
 	nil,					/* internalSubset */
@@ -406,7 +691,7 @@ static xmlSAXHandler saxHandlerStruct = {
 	nil,					/* processingInstruction */
 	nil,					/* comment */
 	nil,					/* warning */
-	errorOccuredSAX,		/* error */
+	nil,					/* error //: replaced by serror */
 	nil,					/* fatalError //: unused error() get all the errors */
 	nil,					/* getParameterEntity */
 	nil,					/* cdataBlock */
@@ -415,5 +700,5 @@ static xmlSAXHandler saxHandlerStruct = {
 	nil,
 	startElementSAX,		/* startElementNs */
 	endElementSAX,			/* endElementNs */
-	nil						/* serror */
+	(xmlStructuredErrorFunc)structuredErrorSAX	/* serror */
 };
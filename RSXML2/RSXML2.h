@@ -29,6 +29,11 @@
 #import <RSXML2/RSDateParser.h>
 #import <RSXML2/RSXMLData.h>
 #import <RSXML2/RSXMLParser.h>
+#import <RSXML2/RSXMLCancelToken.h>
+#import <RSXML2/RSXMLArchiveReader.h>
+#import <RSXML2/RSXMLInternPool.h>
+#import <RSXML2/RSXMLEventReader.h>
+#import <RSXML2/RSXMLSnapshot.h>
 
 // RSS & Atom Feeds
 #import <RSXML2/RSFeedParser.h>
@@ -0,0 +1,87 @@
+//
+//  MIT License (MIT)
+//
+//  Copyright (c) 2018 Oleg Geier
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//  this software and associated documentation files (the "Software"), to deal in
+//  the Software without restriction, including without limitation the rights to
+//  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//  of the Software, and to permit persons to whom the Software is furnished to do
+//  so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#import <Foundation/Foundation.h>
+
+@class RSXMLData;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Called once per record. @c document is the parsed object (@c RSParsedFeed, @c RSOPMLItem, etc.) or @c nil.
+ @c error is set if the record could not be parsed, or if parsing was stopped (partial @c document).
+ */
+typedef void (^RSXMLArchiveResultBlock)(NSUInteger index, RSXMLData *xmlData, id _Nullable document, NSError * _Nullable error);
+
+
+/// Summary of a @c parseConcurrently: run.
+@interface RSXMLArchiveStatistics : NSObject
+@property (nonatomic, readonly) NSUInteger numberOfRecords;
+/// Records without a parsed document (no matching parser, or parsing failed).
+@property (nonatomic, readonly) NSUInteger numberOfFailures;
+/// Records with a parsed document, but an error was reported (e.g., malformed XML that @c libxml recovered from).
+@property (nonatomic, readonly) NSUInteger numberOfRecoveredErrors;
+@property (nonatomic, readonly) unsigned long long numberOfBytes;
+@property (nonatomic, readonly) NSTimeInterval duration;
+@property (nonatomic, readonly) double recordsPerSecond;
+@property (nonatomic, readonly) double bytesPerSecond;
+@end
+
+
+/**
+ Reader for many documents packed into a single archive file.
+ The archive is a plain concatenation of records, all integers are little-endian:
+
+ @code
+ [uint32 url length][uint32 body length][url, UTF-8][body]
+ @endcode
+
+ The file is memory-mapped and records are referenced in place.
+ @c RSXMLData objects point directly into the mapped file, do not set @c dontStopOnLowerAsciiBytes on their parsers.
+ */
+@interface RSXMLArchiveReader : NSObject
+@property (nonatomic, readonly) NSUInteger count;
+/// Sum of all record body lengths.
+@property (nonatomic, readonly) unsigned long long numberOfBytes;
+/// Default: @c NO. Results are delivered in record order. If @c YES, results are delivered as they complete.
+@property (nonatomic, assign) BOOL unordered;
+/// Time budget (in seconds) per record, passed on to each parser. Default: @c 0 (no limit).
+@property (nonatomic, assign) NSTimeInterval timeout;
+
+/// Memory-map archive file. Returns @c nil and sets @c error if the file can't be read or is malformed.
++ (nullable instancetype)readerWithContentsOfURL:(NSURL *)url error:(NSError **)error;
+/// Use already loaded (or mapped) archive data. Returns @c nil and sets @c error if a record is truncated.
+- (nullable instancetype)initWithData:(NSData *)data error:(NSError **)error;
+
+/// @return New @c RSXMLData for record at @c index. Data is not copied.
+- (RSXMLData *)xmlDataAtIndex:(NSUInteger)index;
+/**
+ Parse all records concurrently on all available cores. Blocks until all records are processed.
+ @c block is called on a private serial queue, one record at a time.
+ At most two records per core are in flight (parsing or waiting for delivery).
+ */
+- (RSXMLArchiveStatistics *)parseConcurrently:(RSXMLArchiveResultBlock)block;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,213 @@
+//
+//  MIT License (MIT)
+//
+//  Copyright (c) 2018 Oleg Geier
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//  this software and associated documentation files (the "Software"), to deal in
+//  the Software without restriction, including without limitation the rights to
+//  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//  of the Software, and to permit persons to whom the Software is furnished to do
+//  so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#import <libkern/OSByteOrder.h>
+#import "RSXMLArchiveReader.h"
+#import "RSXMLData.h"
+#import "RSXMLParser.h"
+#import "RSXMLError.h"
+
+/// Byte ranges of a single record, relative to the beginning of the archive.
+typedef struct {
+	NSUInteger urlOffset;
+	NSUInteger urlLength;
+	NSUInteger bodyOffset;
+	NSUInteger bodyLength;
+} RSXMLArchiveRecord;
+
+
+@interface RSXMLArchiveStatistics ()
+@property (nonatomic, assign) NSUInteger numberOfRecords;
+@property (nonatomic, assign) NSUInteger numberOfFailures;
+@property (nonatomic, assign) NSUInteger numberOfRecoveredErrors;
+@property (nonatomic, assign) unsigned long long numberOfBytes;
+@property (nonatomic, assign) NSTimeInterval duration;
+@end
+
+@implementation RSXMLArchiveStatistics
+
+- (double)recordsPerSecond {
+	return (_duration > 0 ? _numberOfRecords / _duration : 0);
+}
+
+- (double)bytesPerSecond {
+	return (_duration > 0 ? _numberOfBytes / _duration : 0);
+}
+
+- (NSString *)description {
+	return [NSString stringWithFormat:@"{%@ records: %lu (%lu failed, %lu recovered), %.1f MB in %.3fs: %.0f records/s, %.1f MB/s}",
+			[self class], (unsigned long)_numberOfRecords, (unsigned long)_numberOfFailures, (unsigned long)_numberOfRecoveredErrors,
+			_numberOfBytes / 1e6, _duration,
+			self.recordsPerSecond, self.bytesPerSecond / 1e6];
+}
+
+@end
+
+
+@interface RSXMLArchiveReader ()
+@property (nonatomic) NSData *archive;
+@property (nonatomic) NSData *records; // C array of RSXMLArchiveRecord
+@end
+
+
+@implementation RSXMLArchiveReader
+
+// docref in header
++ (instancetype)readerWithContentsOfURL:(NSURL *)url error:(NSError **)error {
+	NSData *data = [NSData dataWithContentsOfURL:url options:NSDataReadingMappedAlways error:error];
+	if (!data) {
+		return nil;
+	}
+	return [[self alloc] initWithData:data error:error];
+}
+
+// docref in header
+- (instancetype)initWithData:(NSData *)data error:(NSError **)error {
+	self = [super init];
+	if (self) {
+		_archive = data;
+		if (![self indexRecords]) {
+			if (error) *error = RSXMLMakeError(RSXMLErrorArchiveMalformed, nil);
+			return nil;
+		}
+	}
+	return self;
+}
+
+/**
+ Walk through all length prefixes once. No data is copied.
+ @return @c NO if the last record is truncated.
+ */
+- (BOOL)indexRecords {
+	const unsigned char *bytes = _archive.bytes;
+	const NSUInteger total = _archive.length;
+	NSMutableData *records = [NSMutableData new];
+	unsigned long long sum = 0;
+	NSUInteger pos = 0;
+	while (pos < total) {
+		if (total - pos < 8) {
+			return NO;
+		}
+		RSXMLArchiveRecord r;
+		r.urlLength = OSReadLittleInt32(bytes, pos);
+		r.bodyLength = OSReadLittleInt32(bytes, pos + 4);
+		r.urlOffset = pos + 8;
+		r.bodyOffset = r.urlOffset + r.urlLength;
+		if (r.urlLength > total - r.urlOffset || r.bodyLength > total - r.bodyOffset) {
+			return NO;
+		}
+		[records appendBytes:&r length:sizeof(RSXMLArchiveRecord)];
+		sum += r.bodyLength;
+		pos = r.bodyOffset + r.bodyLength;
+	}
+	_records = records;
+	_count = records.length / sizeof(RSXMLArchiveRecord);
+	_numberOfBytes = sum;
+	return YES;
+}
+
+// docref in header
+- (RSXMLData *)xmlDataAtIndex:(NSUInteger)index {
+	NSParameterAssert(index < _count);
+	RSXMLArchiveRecord r = ((const RSXMLArchiveRecord *)_records.bytes)[index];
+	const char *bytes = _archive.bytes;
+	
+	NSURL *url = nil;
+	NSString *urlString = [[NSString alloc] initWithBytes:bytes + r.urlOffset length:r.urlLength encoding:NSUTF8StringEncoding];
+	if (urlString.length > 0) {
+		url = [NSURL URLWithString:urlString];
+	}
+	if (!url) {
+		url = [NSURL URLWithString:[NSString stringWithFormat:@"archive:record/%lu", (unsigned long)index]];
+	}
+	// keep a reference to the archive until the last record data is released
+	NSData *archive = _archive;
+	NSData *body = [[NSData alloc] initWithBytesNoCopy:(void *)(bytes + r.bodyOffset) length:r.bodyLength deallocator:^(void *b, NSUInteger len) {
+		(void)archive;
+	}];
+	return [[RSXMLData alloc] initWithData:body url:url];
+}
+
+// docref in header
+- (RSXMLArchiveStatistics *)parseConcurrently:(RSXMLArchiveResultBlock)block {
+	
+	const BOOL unordered = self.unordered;
+	const NSTimeInterval timeout = self.timeout;
+	RSXMLArchiveStatistics *stats = [RSXMLArchiveStatistics new];
+	stats.numberOfRecords = _count;
+	stats.numberOfBytes = _numberOfBytes;
+	
+	dispatch_queue_t delivery = dispatch_queue_create("RSXMLArchiveReader.delivery", DISPATCH_QUEUE_SERIAL);
+	dispatch_queue_t workers = dispatch_get_global_queue(QOS_CLASS_UTILITY, 0);
+	dispatch_group_t group = dispatch_group_create();
+	NSMutableDictionary<NSNumber *, dispatch_block_t> *pending = [NSMutableDictionary new];
+	__block NSUInteger nextIndex = 0;
+	// Limit records which are parsed or waiting for delivery. Slots are acquired in record order,
+	// so the next record in order always has a slot and ordered delivery can't stall.
+	dispatch_semaphore_t window = dispatch_semaphore_create(2 * (long)[NSProcessInfo processInfo].activeProcessorCount);
+	
+	CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+	
+	for (NSUInteger i = 0; i < _count; i++) {
+		dispatch_semaphore_wait(window, DISPATCH_TIME_FOREVER);
+		dispatch_group_async(group, workers, ^{
+			@autoreleasepool {
+				RSXMLData *xmlData = [self xmlDataAtIndex:i];
+				RSXMLParser *parser = [xmlData getParser];
+				NSError *error = xmlData.parserError;
+				id document = nil;
+				if (parser) {
+					parser.timeout = timeout;
+					document = [parser parseSync:&error];
+				}
+				dispatch_async(delivery, ^{
+					if (!document) {
+						stats.numberOfFailures += 1;
+					} else if (error) {
+						stats.numberOfRecoveredErrors += 1;
+					}
+					if (unordered) {
+						block(i, xmlData, document, error);
+						dispatch_semaphore_signal(window);
+						return;
+					}
+					pending[@(i)] = ^{ block(i, xmlData, document, error); };
+					dispatch_block_t nextBlock;
+					while ((nextBlock = pending[@(nextIndex)]) != nil) {
+						[pending removeObjectForKey:@(nextIndex)];
+						nextIndex += 1;
+						nextBlock();
+						dispatch_semaphore_signal(window);
+					}
+				});
+			}
+		});
+	}
+	dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+	dispatch_sync(delivery, ^{}); // wait for pending callbacks
+	
+	stats.duration = CFAbsoluteTimeGetCurrent() - start;
+	return stats;
+}
+
+@end
@@ -0,0 +1,69 @@
+//
+//  MIT License (MIT)
+//
+//  Copyright (c) 2018 Oleg Geier
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//  this software and associated documentation files (the "Software"), to deal in
+//  the Software without restriction, including without limitation the rights to
+//  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//  of the Software, and to permit persons to whom the Software is furnished to do
+//  so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#import <Foundation/Foundation.h>
+
+/*
+ Bump allocator for the short-lived memory of a single parse (libxml internals and
+ RSSAXParser scratch buffers). Everything is released at once with RSXMLArenaDestroy().
+
+ Small allocations are carved from shared blocks. A free only reclaims memory if it is
+ the latest allocation of its block. Large allocations get a dedicated block which is
+ returned to the system immediately on free. Blocks are aligned to their size, thus
+ checking whether a pointer belongs to an arena is a single hash set lookup.
+
+ All functions accept a @c NULL arena and fall back to malloc / realloc / free.
+ An arena is not thread-safe, use one per parse.
+ */
+
+typedef struct RSXMLArena RSXMLArena;
+
+/// @param blockSize Size of shared blocks. Pass @c 0 for default (64 KB).
+RSXMLArena *RSXMLArenaCreate(size_t blockSize);
+/// Release all memory of the arena. Pointers allocated from it are invalid afterwards.
+void RSXMLArenaDestroy(RSXMLArena *arena);
+
+void *RSXMLArenaAlloc(RSXMLArena *arena, size_t size);
+/// @c ptr may be allocated by this arena or by the system. System memory stays system memory.
+void *RSXMLArenaRealloc(RSXMLArena *arena, void *ptr, size_t size);
+/// @c ptr may be allocated by this arena or by the system.
+void RSXMLArenaFree(RSXMLArena *arena, void *ptr);
+
+/// @return Maximum number of bytes the arena did hold at any point (block headers included).
+size_t RSXMLArenaHighWaterMark(const RSXMLArena *arena);
+
+/**
+ Route all libxml allocations of the current thread to @c arena. Pass @c NULL to use malloc again.
+
+ Installs the libxml memory hooks on the first call with an arena. Hooks that were installed before
+ are kept and receive all memory that is not owned by an arena (as well as all allocations while no
+ arena is current). Without an arena the overhead is one thread-local read per call.
+
+ Arenas can be nested: an arena made current while another one is current remembers the outer one.
+ Memory of an outer arena may be freed while an inner arena is current (e.g., @c xmlResetLastError()
+ in a nested parse). Everything else is undefined: libxml memory allocated while an arena is current
+ must not be freed on another thread, after switching back, or after the arena is destroyed.
+ Call @c xmlResetLastError() before switching back.
+ @return The previously current arena. Pass it to this function when done.
+ */
+RSXMLArena *RSXMLArenaSetCurrent(RSXMLArena *arena);
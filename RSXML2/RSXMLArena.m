@@ -0,0 +1,422 @@
+//
+//  MIT License (MIT)
+//
+//  Copyright (c) 2018 Oleg Geier
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//  this software and associated documentation files (the "Software"), to deal in
+//  the Software without restriction, including without limitation the rights to
+//  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//  of the Software, and to permit persons to whom the Software is furnished to do
+//  so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#import <libxml/parser.h>
+#import <libxml/xmlmemory.h>
+#import "RSXMLArena.h"
+
+#define kArenaDefaultBlockSize (64 * 1024)
+#define kArenaMinBlockSize (4 * 1024)
+#define kArenaAlignment 16
+#define ArenaRound(size) (((size) + (kArenaAlignment - 1)) & ~(size_t)(kArenaAlignment - 1))
+
+/*
+ Every block starts at a multiple of arena->blockAlignment, and every pointer handed out lies within
+ the first blockAlignment bytes of its block. Masking a pointer yields the address of its block,
+ which is then looked up in the block set of the arena. Ownership is thus O(1) and exact, without
+ reading memory in front of foreign pointers.
+ */
+typedef struct RSXMLArenaBlock {
+	size_t capacity;
+	size_t used;
+	bool dedicated; // holds exactly one (large) allocation
+	char data[] __attribute__((aligned(kArenaAlignment)));
+} RSXMLArenaBlock;
+
+/// Precedes every allocation. Needed to copy the old contents on realloc.
+typedef struct {
+	size_t size;
+	size_t reserved; // keep data aligned
+} RSXMLArenaChunk;
+
+struct RSXMLArena {
+	uintptr_t *blockSet; // open addressing, linear probing. 0 = empty slot
+	size_t blockSetCapacity; // power of two
+	size_t numberOfBlocks;
+	RSXMLArenaBlock *current; // shared block used for bump allocations
+	RSXMLArena *outer; // arena that was current when this one became current (same thread)
+	size_t blockSize; // shared block size, including block header
+	size_t blockAlignment; // power of two >= blockSize
+	size_t bytesInUse;
+	size_t highWaterMark;
+};
+
+
+#pragma mark - Block Set
+
+
+static inline size_t blockSetSlot(const RSXMLArena *arena, uintptr_t block) {
+	return (size_t)((block / arena->blockAlignment) * 0x9E3779B97F4A7C15ull) & (arena->blockSetCapacity - 1);
+}
+
+static bool blockSetContains(const RSXMLArena *arena, uintptr_t block) {
+	if (arena->blockSetCapacity == 0) {
+		return false;
+	}
+	for (size_t i = blockSetSlot(arena, block); arena->blockSet[i] != 0; i = (i + 1) & (arena->blockSetCapacity - 1)) {
+		if (arena->blockSet[i] == block) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void blockSetInsertUnchecked(RSXMLArena *arena, uintptr_t block) {
+	size_t i = blockSetSlot(arena, block);
+	while (arena->blockSet[i] != 0) {
+		i = (i + 1) & (arena->blockSetCapacity - 1);
+	}
+	arena->blockSet[i] = block;
+}
+
+/// @return @c false if the set could not grow.
+static bool blockSetInsert(RSXMLArena *arena, uintptr_t block) {
+	if (2 * (arena->numberOfBlocks + 1) > arena->blockSetCapacity) { // keep load factor below 50%
+		size_t oldCapacity = arena->blockSetCapacity;
+		uintptr_t *old = arena->blockSet;
+		size_t capacity = (oldCapacity > 0 ? 2 * oldCapacity : 16);
+		uintptr_t *grown = calloc(capacity, sizeof(uintptr_t));
+		if (!grown) {
+			return false;
+		}
+		arena->blockSet = grown;
+		arena->blockSetCapacity = capacity;
+		for (size_t i = 0; i < oldCapacity; i++) {
+			if (old[i] != 0) {
+				blockSetInsertUnchecked(arena, old[i]);
+			}
+		}
+		free(old);
+	}
+	blockSetInsertUnchecked(arena, block);
+	arena->numberOfBlocks += 1;
+	return true;
+}
+
+/// Backward shift deletion, no tombstones needed.
+static void blockSetRemove(RSXMLArena *arena, uintptr_t block) {
+	const size_t mask = arena->blockSetCapacity - 1;
+	size_t i = blockSetSlot(arena, block);
+	while (arena->blockSet[i] != block) {
+		if (arena->blockSet[i] == 0) {
+			return;
+		}
+		i = (i + 1) & mask;
+	}
+	size_t j = i;
+	while (true) {
+		j = (j + 1) & mask;
+		if (arena->blockSet[j] == 0) {
+			break;
+		}
+		size_t home = blockSetSlot(arena, arena->blockSet[j]);
+		// move entry j into the gap at i, unless its home slot lies cyclically within (i, j]
+		if ((j > i && (home <= i || home > j)) || (j < i && (home <= i && home > j))) {
+			arena->blockSet[i] = arena->blockSet[j];
+			i = j;
+		}
+	}
+	arena->blockSet[i] = 0;
+	arena->numberOfBlocks -= 1;
+}
+
+
+#pragma mark - Blocks
+
+
+static size_t blockTotalSize(const RSXMLArenaBlock *block) {
+	return sizeof(RSXMLArenaBlock) + block->capacity;
+}
+
+static RSXMLArenaBlock *newBlock(RSXMLArena *arena, size_t capacity, bool dedicated) {
+	void *mem = NULL;
+	if (posix_memalign(&mem, arena->blockAlignment, sizeof(RSXMLArenaBlock) + capacity) != 0) {
+		return NULL;
+	}
+	RSXMLArenaBlock *block = mem;
+	block->capacity = capacity;
+	block->used = 0;
+	block->dedicated = dedicated;
+	if (!blockSetInsert(arena, (uintptr_t)block)) {
+		free(block);
+		return NULL;
+	}
+	arena->bytesInUse += blockTotalSize(block);
+	if (arena->bytesInUse > arena->highWaterMark) {
+		arena->highWaterMark = arena->bytesInUse;
+	}
+	return block;
+}
+
+static void freeBlock(RSXMLArena *arena, RSXMLArenaBlock *block) {
+	blockSetRemove(arena, (uintptr_t)block);
+	arena->bytesInUse -= blockTotalSize(block);
+	if (arena->current == block) {
+		arena->current = NULL;
+	}
+	free(block);
+}
+
+/// @return Block containing @c ptr or @c NULL if @c ptr was not allocated by this arena.
+static RSXMLArenaBlock *owningBlock(const RSXMLArena *arena, const void *ptr) {
+	uintptr_t base = (uintptr_t)ptr & ~(uintptr_t)(arena->blockAlignment - 1);
+	if (!blockSetContains(arena, base)) {
+		return NULL;
+	}
+	RSXMLArenaBlock *block = (RSXMLArenaBlock *)base;
+	const char *p = ptr;
+	if (p > block->data && p < block->data + block->used) { // ptr is always behind a chunk header
+		return block;
+	}
+	return NULL;
+}
+
+static inline RSXMLArenaChunk *chunkForPointer(void *ptr) {
+	return (RSXMLArenaChunk *)ptr - 1;
+}
+
+/// Allocations of size 0 still occupy one alignment unit, so that a pointer never equals the end of its block.
+static inline size_t chunkSize(size_t size) {
+	return sizeof(RSXMLArenaChunk) + ArenaRound(size > 0 ? size : 1);
+}
+
+/// @return @c YES if the allocation at @c ptr is the latest one in @c block.
+static inline bool isLastInBlock(RSXMLArenaBlock *block, void *ptr) {
+	return (char *)chunkForPointer(ptr) + chunkSize(chunkForPointer(ptr)->size) == block->data + block->used;
+}
+
+
+#pragma mark - Arena
+
+
+// docref in header
+RSXMLArena *RSXMLArenaCreate(size_t blockSize) {
+	RSXMLArena *arena = calloc(1, sizeof(RSXMLArena));
+	if (arena) {
+		arena->blockSize = (blockSize > 0 ? MAX(ArenaRound(blockSize), kArenaMinBlockSize) : kArenaDefaultBlockSize);
+		arena->blockAlignment = kArenaMinBlockSize;
+		while (arena->blockAlignment < arena->blockSize) {
+			arena->blockAlignment *= 2;
+		}
+	}
+	return arena;
+}
+
+// docref in header
+void RSXMLArenaDestroy(RSXMLArena *arena) {
+	if (!arena) {
+		return;
+	}
+	for (size_t i = 0; i < arena->blockSetCapacity; i++) {
+		free((void *)arena->blockSet[i]);
+	}
+	free(arena->blockSet);
+	free(arena);
+}
+
+// docref in header
+void *RSXMLArenaAlloc(RSXMLArena *arena, size_t size) {
+	if (!arena) {
+		return malloc(size);
+	}
+	if (size > SIZE_MAX / 2) {
+		return NULL;
+	}
+	size_t needed = chunkSize(size);
+	const size_t sharedCapacity = arena->blockSize - sizeof(RSXMLArenaBlock);
+	RSXMLArenaBlock *block;
+	if (needed > sharedCapacity / 4) {
+		block = newBlock(arena, needed, true);
+	} else {
+		block = arena->current;
+		if (!block || block->capacity - block->used < needed) {
+			block = newBlock(arena, sharedCapacity, false);
+			if (block) {
+				arena->current = block;
+			}
+		}
+	}
+	if (!block) {
+		return NULL;
+	}
+	RSXMLArenaChunk *chunk = (RSXMLArenaChunk *)(block->data + block->used);
+	chunk->size = size;
+	block->used += needed;
+	return chunk + 1;
+}
+
+/// Realloc for @c ptr owned by @c block of @c arena.
+static void *reallocOwned(RSXMLArena *arena, RSXMLArenaBlock *block, void *ptr, size_t size) {
+	if (size > SIZE_MAX / 2) {
+		return NULL;
+	}
+	size_t oldSize = chunkForPointer(ptr)->size;
+	if (!block->dedicated && isLastInBlock(block, ptr)) { // grow or shrink in place
+		size_t offset = (size_t)((char *)chunkForPointer(ptr) - block->data);
+		size_t needed = chunkSize(size);
+		if (offset + needed <= block->capacity) {
+			block->used = offset + needed;
+			chunkForPointer(ptr)->size = size;
+			return ptr;
+		}
+	}
+	void *newPtr = RSXMLArenaAlloc(arena, size);
+	if (newPtr) {
+		memcpy(newPtr, ptr, MIN(oldSize, size));
+		if (block->dedicated) { // return large blocks immediately, realloc() would not keep the alignment
+			freeBlock(arena, block);
+		}
+	}
+	return newPtr;
+}
+
+/// Free for @c ptr owned by @c block of @c arena.
+static void freeOwned(RSXMLArena *arena, RSXMLArenaBlock *block, void *ptr) {
+	if (block->dedicated) {
+		freeBlock(arena, block);
+	} else if (isLastInBlock(block, ptr)) {
+		block->used = (size_t)((char *)chunkForPointer(ptr) - block->data);
+	}
+}
+
+// docref in header
+void *RSXMLArenaRealloc(RSXMLArena *arena, void *ptr, size_t size) {
+	if (!arena) {
+		return realloc(ptr, size);
+	}
+	if (!ptr) {
+		return RSXMLArenaAlloc(arena, size);
+	}
+	RSXMLArenaBlock *block = owningBlock(arena, ptr);
+	if (!block) {
+		return realloc(ptr, size);
+	}
+	return reallocOwned(arena, block, ptr, size);
+}
+
+// docref in header
+void RSXMLArenaFree(RSXMLArena *arena, void *ptr) {
+	if (!ptr) {
+		return;
+	}
+	RSXMLArenaBlock *block = (arena ? owningBlock(arena, ptr) : NULL);
+	if (block) {
+		freeOwned(arena, block, ptr);
+	} else {
+		free(ptr);
+	}
+}
+
+// docref in header
+size_t RSXMLArenaHighWaterMark(const RSXMLArena *arena) {
+	return (arena ? arena->highWaterMark : 0);
+}
+
+
+#pragma mark - libxml Memory Hooks
+
+
+static _Thread_local RSXMLArena *currentArena;
+// hooks which were installed before ours. Everything not owned by an arena is forwarded.
+static xmlFreeFunc previousFree;
+static xmlMallocFunc previousMalloc;
+static xmlReallocFunc previousRealloc;
+static xmlStrdupFunc previousStrdup;
+
+/// Search the current arena and the arenas it is nested in (e.g., a parse started from a delegate callback).
+static RSXMLArena *owningArena(const void *ptr, RSXMLArenaBlock **block) {
+	for (RSXMLArena *arena = currentArena; arena; arena = arena->outer) {
+		*block = owningBlock(arena, ptr);
+		if (*block) {
+			return arena;
+		}
+	}
+	return NULL;
+}
+
+static void *arenaMallocHook(size_t size) {
+	RSXMLArena *arena = currentArena;
+	return (arena ? RSXMLArenaAlloc(arena, size) : previousMalloc(size));
+}
+
+static void *arenaReallocHook(void *ptr, size_t size) {
+	if (!ptr) {
+		return arenaMallocHook(size);
+	}
+	RSXMLArenaBlock *block;
+	RSXMLArena *owner = owningArena(ptr, &block);
+	return (owner ? reallocOwned(owner, block, ptr, size) : previousRealloc(ptr, size));
+}
+
+static void arenaFreeHook(void *ptr) {
+	if (!ptr) {
+		return;
+	}
+	RSXMLArenaBlock *block;
+	RSXMLArena *owner = owningArena(ptr, &block);
+	if (owner) {
+		freeOwned(owner, block, ptr);
+	} else {
+		previousFree(ptr);
+	}
+}
+
+static char *arenaStrdupHook(const char *str) {
+	RSXMLArena *arena = currentArena;
+	if (!arena) {
+		return previousStrdup(str);
+	}
+	size_t length = strlen(str) + 1;
+	char *copy = RSXMLArenaAlloc(arena, length);
+	if (copy) {
+		memcpy(copy, str, length);
+	}
+	return copy;
+}
+
+// docref in header
+RSXMLArena *RSXMLArenaSetCurrent(RSXMLArena *arena) {
+	static dispatch_once_t onceToken;
+	if (arena) { // no hooks unless an arena is actually used
+		dispatch_once(&onceToken, ^{
+			xmlInitParser(); // global libxml state must not end up in an arena
+			xmlMemGet(&previousFree, &previousMalloc, &previousRealloc, &previousStrdup);
+			xmlMemSetup(arenaFreeHook, arenaMallocHook, arenaReallocHook, arenaStrdupHook);
+		});
+	}
+	RSXMLArena *previous = currentArena;
+	if (arena && arena != previous) {
+		bool leaving = false; // switching back to an outer arena
+		for (RSXMLArena *outer = previous; outer; outer = outer->outer) {
+			if (outer == arena) {
+				leaving = true;
+				break;
+			}
+		}
+		if (!leaving) {
+			arena->outer = previous;
+		}
+	}
+	currentArena = arena;
+	return previous;
+}
@@ -50,13 +50,14 @@ static const NSUInteger numberOfCharactersToSearch = 4096;
 
 /**
  Get location of @c str in data. May be inaccurate since UTF8 uses multi-byte characters.
+ Data is not required to be @c NUL terminated (e.g., records of @c RSXMLArchiveReader).
  */
 - (NSInteger)findCString:(const char*)str {
-	char *foundStr = strnstr(_data.bytes, str, numberOfCharactersToSearch);
+	const char *foundStr = memmem(_data.bytes, MIN(numberOfCharactersToSearch, _data.length), str, strlen(str));
 	if (foundStr == NULL) {
 		return NSNotFound;
 	}
-	return foundStr - (char*)_data.bytes;
+	return foundStr - (const char*)_data.bytes;
 }
 
 /**
@@ -84,7 +85,7 @@ static const NSUInteger numberOfCharactersToSearch = 4096;
 }
 
 /**
- Do a fast @c strnstr() search on the @c char* data.
+ Do a fast @c memmem() search on the @c char* data.
  All strings must match exactly and in the same order provided.
  */
 - (BOOL)matchAllInCorrectOrder:(const char*[])tags count:(int)len {
@@ -38,7 +38,15 @@ typedef NS_ERROR_ENUM(kRSXMLParserErrorDomain, RSXMLError) {
 	// 2xx: xml content <-> parser, mismatch
 	RSXMLErrorExpectingFeed        = 210,
 	RSXMLErrorExpectingHTML        = 220,
-	RSXMLErrorExpectingOPML        = 230
+	RSXMLErrorExpectingOPML        = 230,
+	// 3xx: parsing interrupted (partial results are returned)
+	RSXMLErrorCanceled             = 310, // cancel token was triggered
+	RSXMLErrorTimeout              = 320, // parsing exceeded the time budget
+	RSXMLErrorTooManyErrors        = 330, // libxml reported more errors than allowed
+	// 4xx: bulk input
+	RSXMLErrorArchiveMalformed     = 410, // archive record length exceeds file size
+	RSXMLErrorSnapshotMalformed    = 420, // snapshot header or table out of bounds
+	RSXMLErrorSnapshotVersion      = 421  // snapshot was written by a newer version
 };
 
 NSError * RSXMLMakeError(RSXMLError code, NSURL *uri);
@@ -53,6 +53,18 @@ NSString * getErrorMessageForRSXMLError(RSXMLError code, RSXMLError other) {
 		case RSXMLErrorExpectingFeed:
 			return [NSString stringWithFormat:@"Can't parse XML. %s expected, but %s found.",
 					parserDescriptionForError(code), parserDescriptionForError(other)];
+		case RSXMLErrorCanceled:
+			return @"Parsing canceled. Document is incomplete.";
+		case RSXMLErrorTimeout:
+			return @"Parsing took too long and was stopped. Document is incomplete.";
+		case RSXMLErrorTooManyErrors:
+			return @"Document contains too many errors. Parsing was stopped, document is incomplete.";
+		case RSXMLErrorArchiveMalformed:
+			return @"Can't read archive. Record length exceeds file size.";
+		case RSXMLErrorSnapshotMalformed:
+			return @"Can't read snapshot. Data is truncated or not a snapshot.";
+		case RSXMLErrorSnapshotVersion:
+			return @"Can't read snapshot. Unsupported format version.";
 	}
 }
 
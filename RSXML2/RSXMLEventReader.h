@@ -0,0 +1,97 @@
+//
+//  MIT License (MIT)
+//
+//  Copyright (c) 2018 Oleg Geier
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//  this software and associated documentation files (the "Software"), to deal in
+//  the Software without restriction, including without limitation the rights to
+//  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//  of the Software, and to permit persons to whom the Software is furnished to do
+//  so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSInteger, RSXMLEventType) {
+	RSXMLEventEndDocument = 0,
+	RSXMLEventStartElement,
+	RSXMLEventEndElement,
+	RSXMLEventText
+};
+
+/**
+ Single event of @c RSXMLEventReader.
+ 
+ @c name and @c prefix point into the @c libxml name dictionary and stay valid until the reader
+ reaches @c RSXMLEventEndDocument. @c bytes (text content) is valid until the next @c nextEvent call.
+ */
+typedef struct {
+	RSXMLEventType type;
+	/// Element depth, root element is @c 1. For text: depth of the enclosing element.
+	NSUInteger depth;
+	/// Local name (NUL terminated). @c NULL for text events.
+	const char * _Nullable name;
+	/// Namespace prefix or @c NULL.
+	const char * _Nullable prefix;
+	/// UTF-8 text content, not NUL terminated. @c NULL for element events.
+	const char * _Nullable bytes;
+	NSUInteger length;
+	/// Only set for start element events. Use @c attributeAtIndex: to access them.
+	NSUInteger numberOfAttributes;
+} RSXMLEvent;
+
+typedef struct {
+	const char *name;
+	const char * _Nullable prefix;
+	/// UTF-8, not NUL terminated. Same lifetime as @c RSXMLEvent.bytes
+	const char *value;
+	NSUInteger length;
+} RSXMLEventAttribute;
+
+
+/**
+ Pull parser for XML documents. The consumer asks for the next event, the document is parsed
+ lazily in small chunks as needed. Use this for targeted extraction where the full
+ @c RSParsedFeed model is not needed.
+
+ @code
+ RSXMLEvent e;
+ while ((e = [reader nextEvent]).type != RSXMLEventEndDocument) {
+     if (e.type == RSXMLEventStartElement && strcmp(e.name, "content") == 0)
+         [reader skipSubtree];
+ }
+ @endcode
+ */
+@interface RSXMLEventReader : NSObject
+/// First @c libxml error (if any).
+@property (nonatomic, readonly, nullable) NSError *parsingError;
+
+- (instancetype)initWithData:(NSData *)data;
+
+/// @return Next event. Returns @c RSXMLEventEndDocument once the document is finished (and for any call thereafter).
+- (RSXMLEvent)nextEvent;
+/**
+ Call right after a @c RSXMLEventStartElement event. Discards all events up to and including the
+ matching end element. Skipped text and attributes are never copied.
+ */
+- (void)skipSubtree;
+/// @return Attribute of the latest start element event. @c index must be less than @c numberOfAttributes.
+- (RSXMLEventAttribute)attributeAtIndex:(NSUInteger)index;
+/// @return Value of unprefixed attribute @c name of the latest start element event, or @c NULL if not found.
+- (nullable const char *)valueForAttribute:(const char *)name length:(NSUInteger *)length;
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,307 @@
+//
+//  MIT License (MIT)
+//
+//  Copyright (c) 2018 Oleg Geier
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//  this software and associated documentation files (the "Software"), to deal in
+//  the Software without restriction, including without limitation the rights to
+//  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//  of the Software, and to permit persons to whom the Software is furnished to do
+//  so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#import <libxml/xmlstring.h>
+#import "RSXMLEventReader.h"
+#import "RSSAXParser.h"
+
+/// Input is handed to libxml in chunks of this size whenever the event queue runs empty.
+#define kReaderChunkSize (16 * 1024)
+
+/// Queued event. Text is stored as offset because the scratch buffer may move.
+typedef struct {
+	RSXMLEventType type;
+	NSUInteger depth;
+	const xmlChar *name;
+	const xmlChar *prefix;
+	NSUInteger offset;
+	NSUInteger length;
+	NSUInteger firstAttribute;
+	NSUInteger numberOfAttributes;
+} RSXMLQueuedEvent;
+
+typedef struct {
+	const xmlChar *name;
+	const xmlChar *prefix;
+	NSUInteger offset;
+	NSUInteger length;
+} RSXMLQueuedAttribute;
+
+/// Ensure @c buffer can hold @c needed elements. @return @c NO if out of memory.
+static BOOL growBuffer(void **buffer, NSUInteger *capacity, NSUInteger needed, size_t elementSize) {
+	if (needed <= *capacity) {
+		return YES;
+	}
+	NSUInteger newCapacity = MAX(needed, *capacity * 2);
+	void *newBuffer = realloc(*buffer, newCapacity * elementSize);
+	if (!newBuffer) {
+		return NO;
+	}
+	*buffer = newBuffer;
+	*capacity = newCapacity;
+	return YES;
+}
+
+
+@interface RSXMLEventReader () <RSSAXParserDelegate>
+@end
+
+@implementation RSXMLEventReader {
+	NSData *_data;
+	NSUInteger _dataOffset;
+	RSSAXParser *_parser;
+	BOOL _inputFinished; // last chunk was handed to libxml
+	BOOL _documentFinished; // parser context is freed, names are invalid
+	NSUInteger _depth;
+	NSUInteger _skipDepth; // 0 = not skipping
+	RSXMLQueuedEvent _currentEvent; // latest event returned by nextEvent
+	BOOL _canSkip;
+	// events of the current chunk, consumed front to back
+	RSXMLQueuedEvent *_events;
+	NSUInteger _eventCount, _eventCapacity, _eventIndex;
+	RSXMLQueuedAttribute *_attributes;
+	NSUInteger _attributeCount, _attributeCapacity;
+	// copied text and attribute values of the current chunk
+	char *_scratch;
+	NSUInteger _scratchLength, _scratchCapacity;
+}
+
++ (BOOL)isHTMLParser { return NO; }
+
+// docref in header
+- (instancetype)initWithData:(NSData *)data {
+	self = [super init];
+	if (self) {
+		_data = data;
+		_parser = [[RSSAXParser alloc] initWithDelegate:self];
+		growBuffer((void **)&_events, &_eventCapacity, 256, sizeof(RSXMLQueuedEvent));
+		growBuffer((void **)&_attributes, &_attributeCapacity, 64, sizeof(RSXMLQueuedAttribute));
+		growBuffer((void **)&_scratch, &_scratchCapacity, kReaderChunkSize, sizeof(char));
+	}
+	return self;
+}
+
+- (void)dealloc {
+	[_parser finishParsing]; // consumer may stop before the end of the document
+	free(_events);
+	free(_attributes);
+	free(_scratch);
+}
+
+// docref in header
+- (NSError *)parsingError {
+	return _parser.parsingError;
+}
+
+
+#pragma mark - Pull API
+
+
+// docref in header
+- (RSXMLEvent)nextEvent {
+	_canSkip = NO;
+	while (_eventIndex >= _eventCount) {
+		if (![self parseNextChunk]) {
+			_currentEvent = (RSXMLQueuedEvent){ .type = RSXMLEventEndDocument };
+			return (RSXMLEvent){ .type = RSXMLEventEndDocument };
+		}
+	}
+	_currentEvent = _events[_eventIndex++];
+	_canSkip = (_currentEvent.type == RSXMLEventStartElement);
+	
+	RSXMLEvent event = {
+		.type = _currentEvent.type,
+		.depth = _currentEvent.depth,
+		.name = (const char *)_currentEvent.name,
+		.prefix = (const char *)_currentEvent.prefix,
+		.bytes = NULL,
+		.length = _currentEvent.length,
+		.numberOfAttributes = _currentEvent.numberOfAttributes,
+	};
+	if (event.type == RSXMLEventText) {
+		event.bytes = _scratch + _currentEvent.offset;
+	}
+	return event;
+}
+
+/// Clear event queue and parse the next chunk of input. @return @c NO if the document is finished.
+- (BOOL)parseNextChunk {
+	_eventCount = _eventIndex = 0;
+	_attributeCount = 0;
+	_scratchLength = 0;
+	
+	if (_inputFinished) {
+		if (!_documentFinished) {
+			_documentFinished = YES;
+			[_parser finishParsing];
+		}
+		return NO;
+	}
+	NSUInteger length = MIN(_data.length - _dataOffset, (NSUInteger)kReaderChunkSize);
+	_inputFinished = (_dataOffset + length == _data.length);
+	[_parser parseChunk:(const char *)_data.bytes + _dataOffset numberOfBytes:length isLastChunk:_inputFinished];
+	_dataOffset += length;
+	return YES;
+}
+
+// docref in header
+- (void)skipSubtree {
+	if (!_canSkip) {
+		return;
+	}
+	_canSkip = NO;
+	NSUInteger depth = _currentEvent.depth;
+	while (_eventIndex < _eventCount) { // drop already queued events
+		RSXMLQueuedEvent *event = &_events[_eventIndex++];
+		if (event->type == RSXMLEventEndElement && event->depth == depth) {
+			return;
+		}
+	}
+	_skipDepth = depth; // and all upcoming events until the matching end element
+}
+
+// docref in header
+- (RSXMLEventAttribute)attributeAtIndex:(NSUInteger)index {
+	NSAssert(index < _currentEvent.numberOfAttributes, @"Attribute index out of bounds");
+	if (index >= _currentEvent.numberOfAttributes) {
+		return (RSXMLEventAttribute){ 0 };
+	}
+	RSXMLQueuedAttribute *attribute = &_attributes[_currentEvent.firstAttribute + index];
+	return (RSXMLEventAttribute){
+		.name = (const char *)attribute->name,
+		.prefix = (const char *)attribute->prefix,
+		.value = _scratch + attribute->offset,
+		.length = attribute->length,
+	};
+}
+
+// docref in header
+- (const char *)valueForAttribute:(const char *)name length:(NSUInteger *)length {
+	for (NSUInteger i = 0; i < _currentEvent.numberOfAttributes; i++) {
+		RSXMLQueuedAttribute *attribute = &_attributes[_currentEvent.firstAttribute + i];
+		if (!attribute->prefix && strcmp((const char *)attribute->name, name) == 0) {
+			if (length) *length = attribute->length;
+			return _scratch + attribute->offset;
+		}
+	}
+	return NULL;
+}
+
+
+#pragma mark - Queue
+
+
+/// @return New event at the end of the queue or @c NULL if out of memory.
+- (RSXMLQueuedEvent *)enqueueEvent:(RSXMLEventType)type depth:(NSUInteger)depth {
+	if (!growBuffer((void **)&_events, &_eventCapacity, _eventCount + 1, sizeof(RSXMLQueuedEvent))) {
+		return NULL;
+	}
+	RSXMLQueuedEvent *event = &_events[_eventCount++];
+	*event = (RSXMLQueuedEvent){ .type = type, .depth = depth };
+	return event;
+}
+
+/// Copy @c bytes to scratch buffer. @return Offset of the copy or @c NSNotFound if out of memory.
+- (NSUInteger)appendBytes:(const void *)bytes length:(NSUInteger)length {
+	if (!growBuffer((void **)&_scratch, &_scratchCapacity, _scratchLength + length, sizeof(char))) {
+		return NSNotFound;
+	}
+	NSUInteger offset = _scratchLength;
+	memcpy(_scratch + offset, bytes, length);
+	_scratchLength += length;
+	return offset;
+}
+
+
+#pragma mark - RSSAXParserDelegate
+
+
+- (void)saxParser:(RSSAXParser *)SAXParser XMLStartElement:(const unsigned char *)localName prefix:(const unsigned char *)prefix uri:(const unsigned char *)uri numberOfNamespaces:(NSInteger)numberOfNamespaces namespaces:(const unsigned char **)namespaces numberOfAttributes:(NSInteger)numberOfAttributes numberDefaulted:(int)numberDefaulted attributes:(const unsigned char **)attributes {
+	
+	_depth++;
+	if (_skipDepth > 0) {
+		return;
+	}
+	RSXMLQueuedEvent *event = [self enqueueEvent:RSXMLEventStartElement depth:_depth];
+	if (!event) {
+		return;
+	}
+	event->name = localName;
+	event->prefix = prefix;
+	event->firstAttribute = _attributeCount;
+	
+	if (numberOfAttributes < 1 || !growBuffer((void **)&_attributes, &_attributeCapacity, _attributeCount + (NSUInteger)numberOfAttributes, sizeof(RSXMLQueuedAttribute))) {
+		return;
+	}
+	for (NSInteger i = 0, j = 0; i < numberOfAttributes; i++, j+=5) {
+		NSUInteger length = (NSUInteger)(attributes[j + 4] - attributes[j + 3]);
+		NSUInteger offset = [self appendBytes:attributes[j + 3] length:length];
+		if (offset == NSNotFound) {
+			break;
+		}
+		_attributes[_attributeCount++] = (RSXMLQueuedAttribute){ attributes[j], attributes[j + 1], offset, length };
+		event->numberOfAttributes++;
+	}
+}
+
+- (void)saxParser:(RSSAXParser *)SAXParser XMLEndElement:(const unsigned char *)localName prefix:(const unsigned char *)prefix uri:(const unsigned char *)uri {
+	
+	NSUInteger depth = _depth--;
+	if (_skipDepth > 0) {
+		if (depth == _skipDepth) {
+			_skipDepth = 0;
+		}
+		return;
+	}
+	RSXMLQueuedEvent *event = [self enqueueEvent:RSXMLEventEndElement depth:depth];
+	if (event) {
+		event->name = localName;
+		event->prefix = prefix;
+	}
+}
+
+- (void)saxParser:(RSSAXParser *)SAXParser XMLCharactersFound:(const unsigned char *)characters length:(NSUInteger)length {
+	
+	if (_skipDepth > 0) {
+		return;
+	}
+	// libxml may report text in pieces, extend the previous text event if possible
+	RSXMLQueuedEvent *last = (_eventCount > _eventIndex ? &_events[_eventCount - 1] : NULL);
+	if (last && last->type == RSXMLEventText && last->offset + last->length == _scratchLength) {
+		if ([self appendBytes:characters length:length] != NSNotFound) {
+			last->length += length;
+		}
+		return;
+	}
+	NSUInteger offset = [self appendBytes:characters length:length];
+	if (offset == NSNotFound) {
+		return;
+	}
+	RSXMLQueuedEvent *event = [self enqueueEvent:RSXMLEventText depth:_depth];
+	if (event) {
+		event->offset = offset;
+		event->length = length;
+	}
+}
+
+@end
@@ -0,0 +1,40 @@
+//
+//  MIT License (MIT)
+//
+//  Copyright (c) 2018 Oleg Geier
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//  this software and associated documentation files (the "Software"), to deal in
+//  the Software without restriction, including without limitation the rights to
+//  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//  of the Software, and to permit persons to whom the Software is furnished to do
+//  so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#import <Foundation/Foundation.h>
+
+/*Bounded string intern table for short, frequently repeated values
+ (attribute values, author names, categories, MIME types, etc.).
+
+ Each thread has its own table, no locking involved. The table is direct-mapped with a fixed
+ number of slots; a colliding string simply replaces the previous one. Memory stays bounded.*/
+
+
+/// Strings longer than this (in bytes) are not interned.
+extern const NSUInteger RSXMLInternPoolMaxLength;
+
+/**
+ @return Shared immutable string for UTF-8 encoded @c bytes. Repeated calls on the same thread
+ return the same instance. Returns @c nil if @c length exceeds @c RSXMLInternPoolMaxLength or bytes are not valid UTF-8.
+ */
+NSString *RSXMLInternedString(const void *bytes, NSUInteger length);
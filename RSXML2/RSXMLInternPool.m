@@ -0,0 +1,104 @@
+//
+//  MIT License (MIT)
+//
+//  Copyright (c) 2018 Oleg Geier
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//  this software and associated documentation files (the "Software"), to deal in
+//  the Software without restriction, including without limitation the rights to
+//  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//  of the Software, and to permit persons to whom the Software is furnished to do
+//  so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#import <pthread.h>
+#import "RSXMLInternPool.h"
+
+#define kInternMaxLength 47
+#define kInternSlotCount 1024 // must be a power of 2
+
+const NSUInteger RSXMLInternPoolMaxLength = kInternMaxLength;
+
+typedef struct {
+	CFStringRef string;
+	uint32_t hash;
+	uint8_t length;
+	char bytes[kInternMaxLength];
+} RSXMLInternSlot;
+
+
+static pthread_key_t internPoolKey;
+
+static void freeInternPool(void *table) {
+	RSXMLInternSlot *slots = table;
+	for (NSUInteger i = 0; i < kInternSlotCount; i++) {
+		if (slots[i].string) {
+			CFRelease(slots[i].string);
+		}
+	}
+	free(table);
+}
+
+/// @return Intern table of the current thread. Created on first use and freed on thread exit.
+static RSXMLInternSlot *currentInternPool(void) {
+	static dispatch_once_t onceToken;
+	dispatch_once(&onceToken, ^{
+		pthread_key_create(&internPoolKey, freeInternPool);
+	});
+	RSXMLInternSlot *table = pthread_getspecific(internPoolKey);
+	if (!table) {
+		table = calloc(kInternSlotCount, sizeof(RSXMLInternSlot));
+		pthread_setspecific(internPoolKey, table);
+	}
+	return table;
+}
+
+/// FNV-1a
+static inline uint32_t internHash(const unsigned char *bytes, NSUInteger length) {
+	uint32_t h = 2166136261u;
+	for (NSUInteger i = 0; i < length; i++) {
+		h = (h ^ bytes[i]) * 16777619u;
+	}
+	return h;
+}
+
+// docref in header
+NSString *RSXMLInternedString(const void *bytes, NSUInteger length) {
+	if (length == 0) {
+		return @"";
+	}
+	if (length > kInternMaxLength) {
+		return nil;
+	}
+	RSXMLInternSlot *table = currentInternPool();
+	if (!table) {
+		return nil;
+	}
+	uint32_t h = internHash(bytes, length);
+	RSXMLInternSlot *slot = &table[h & (kInternSlotCount - 1)];
+	if (slot->string && slot->hash == h && slot->length == length && memcmp(slot->bytes, bytes, length) == 0) {
+		return (__bridge NSString *)slot->string;
+	}
+	CFStringRef str = CFStringCreateWithBytes(kCFAllocatorDefault, bytes, (CFIndex)length, kCFStringEncodingUTF8, false);
+	if (!str) {
+		return nil;
+	}
+	if (slot->string) {
+		CFRelease(slot->string);
+	}
+	slot->string = str;
+	slot->hash = h;
+	slot->length = (uint8_t)length;
+	memcpy(slot->bytes, bytes, length);
+	return (__bridge NSString *)str;
+}
@@ -27,7 +27,7 @@
 #define EqualBytes(bytes1, bytes2, length) (memcmp(bytes1, bytes2, length) == 0)
 //#define EqualBytes(bytes1, bytes2, length) (!strncmp(bytes1, bytes2, length))
 
-@class RSXMLData;
+@class RSXMLData, RSXMLCancelToken;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -48,6 +48,11 @@ NS_ASSUME_NONNULL_BEGIN
 + (NSArray<const NSString *> *)parserRequireOrderedTags;
 /// @return Return @c NO to cancel parsing before it even started. E.g. check if parser is of correct type.
 - (BOOL)xmlParserWillStartParsing;
+/**
+ Called after @c xmlParserWillStartParsing. A subclass may process the raw data without @c libxml.
+ @return @c YES if the document is complete and the SAX parser should be skipped.
+ */
+- (BOOL)xmlParserHandledDataWithoutSAX:(NSData *)data;
 
 @required
 /// @return @c YES if parser supports parsing feeds (RSS or Atom).
@@ -72,6 +77,20 @@ NS_ASSUME_NONNULL_BEGIN
 @interface RSXMLParser<__covariant T> : NSObject <RSXMLParserDelegate, RSSAXParserDelegate>
 @property (nonatomic, readonly, nonnull, copy) NSURL *documentURI;
 @property (nonatomic, assign) BOOL dontStopOnLowerAsciiBytes;
+/// Time budget (in seconds) for each @c parseSync: call. Exceeding it returns a partial document and @c RSXMLErrorTimeout.
+@property (nonatomic, assign) NSTimeInterval timeout;
+/// Trigger from any thread to stop parsing. Returns a partial document and @c RSXMLErrorCanceled.
+@property (nonatomic, strong, nullable) RSXMLCancelToken *cancelToken;
+/// Default: @c NO. Share repeated short strings (attribute values, authors, categories, ...) via a per-thread intern pool.
+@property (nonatomic, assign) BOOL internStrings;
+/// Default: @c NO. Serve @c libxml allocations and scratch buffers of each parse from a single arena.
+@property (nonatomic, assign) BOOL useArena;
+/// Peak arena memory (in bytes) of the last @c parseSync: call. @c 0 if @c useArena is not set.
+@property (nonatomic, assign, readonly) NSUInteger memoryHighWaterMark;
+/// Give up on badly broken documents. Exceeding it returns a partial document and @c RSXMLErrorTooManyErrors. Default: @c 0 (no limit).
+@property (nonatomic, assign) NSUInteger maxErrorCount;
+/// Line, column and code of the most recent (up to 64) @c libxml errors of the last @c parseSync: call.
+@property (nonatomic, copy, readonly, nonnull) NSArray<NSError*> *allParsingErrors;
 
 /**
  Designated initializer. Runs a check whether it matches the detected parser in @c RSXMLData.
@@ -83,6 +102,7 @@ NS_ASSUME_NONNULL_BEGIN
  Parse the XML data on whatever thread this method is called.
  
  @param error Sets @c error if parser gets unrecognized data or @c libxml runs into a parsing error.
+              Or if parsing was interrupted by @c timeout, @c cancelToken or @c maxErrorCount (document is incomplete).
  @return The parsed object. The object type depends on the underlying data. @c RSParsedFeed, @c RSOPMLItem or @c RSHTMLMetadata.
  */
 - (T _Nullable)parseSync:(NSError ** _Nullable)error;
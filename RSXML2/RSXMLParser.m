@@ -93,14 +93,43 @@
 	}
 	if ([self respondsToSelector:@selector(xmlParserWillStartParsing)] && ![self xmlParserWillStartParsing])
 		return nil;
+	if ([self respondsToSelector:@selector(xmlParserHandledDataWithoutSAX:)] && [self xmlParserHandledDataWithoutSAX:_xmlData]) {
+		if (error) *error = nil;
+		return [self xmlParserWillReturnDocument];
+	}
 
+	_parser.timeout = _timeout;
+	_parser.cancelToken = _cancelToken;
+	_parser.internStrings = _internStrings;
+	_parser.useArena = _useArena;
+	_parser.maxErrorCount = _maxErrorCount;
 	@autoreleasepool {
 		[_parser parseBytes:_xmlData.bytes numberOfBytes:_xmlData.length];
 	}
-	if (error) *error = _parser.parsingError;
+	if (error) *error = [self parsingErrorOrInterruption];
 	return [self xmlParserWillReturnDocument];
 }
 
+// docref in header
+- (NSUInteger)memoryHighWaterMark {
+	return _parser.memoryHighWaterMark;
+}
+
+// docref in header
+- (NSArray<NSError*> *)allParsingErrors {
+	return _parser.allParsingErrors;
+}
+
+/// @return Timeout, cancel or error limit error if parsing was interrupted. Otherwise the first @c libxml error (if any).
+- (NSError *)parsingErrorOrInterruption {
+	switch (_parser.interruption) {
+		case RSSAXParserCanceled: return RSXMLMakeError(RSXMLErrorCanceled, _documentURI);
+		case RSSAXParserTimedOut: return RSXMLMakeError(RSXMLErrorTimeout, _documentURI);
+		case RSSAXParserTooManyErrors: return RSXMLMakeError(RSXMLErrorTooManyErrors, _documentURI);
+		case RSSAXParserNotInterrupted: return _parser.parsingError;
+	}
+}
+
 // docref in header
 - (void)parseAsync:(void(^)(id parsedDocument, NSError *error))block {
 	dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{ // QOS_CLASS_DEFAULT
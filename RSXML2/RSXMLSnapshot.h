@@ -0,0 +1,114 @@
+//
+//  MIT License (MIT)
+//
+//  Copyright (c) 2018 Oleg Geier
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//  this software and associated documentation files (the "Software"), to deal in
+//  the Software without restriction, including without limitation the rights to
+//  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//  of the Software, and to permit persons to whom the Software is furnished to do
+//  so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#import <Foundation/Foundation.h>
+
+@class RSParsedFeed, RSOPMLItem;
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(uint16_t, RSXMLSnapshotKind) {
+	RSXMLSnapshotKindFeed = 1,
+	RSXMLSnapshotKindOPML = 2
+};
+
+/// String fields of the feed, in storage order.
+typedef NS_ENUM(NSUInteger, RSXMLSnapshotFeedField) {
+	RSXMLSnapshotFeedURL = 0,
+	RSXMLSnapshotFeedTitle,
+	RSXMLSnapshotFeedLink,
+	RSXMLSnapshotFeedSubtitle
+};
+
+/// String fields of an article, in storage order.
+typedef NS_ENUM(NSUInteger, RSXMLSnapshotArticleField) {
+	RSXMLSnapshotArticleID = 0,
+	RSXMLSnapshotArticleGuid,
+	RSXMLSnapshotArticleTitle,
+	RSXMLSnapshotArticleAbstract,
+	RSXMLSnapshotArticleBody,
+	RSXMLSnapshotArticleLink,
+	RSXMLSnapshotArticlePermalink,
+	RSXMLSnapshotArticleAuthor
+};
+
+
+/**
+ Compact binary encoding of parse results (@c RSParsedFeed or @c RSOPMLItem) to pass between
+ processes or store on disk. Reloading is much faster than parsing the XML again.
+
+ The format is versioned and little-endian. Header, fixed-size record tables, and one string blob.
+ Strings are stored as offset and length (UTF-8, NUL terminated), dates as milliseconds since 1970.
+ Opening a snapshot validates the header and the table bounds (for OPML also the item tree, one pass over
+ fixed-size records). Records are read in place on access, no deserialization pass.
+ */
+@interface RSXMLSnapshot : NSObject
+@property (nonatomic, readonly) RSXMLSnapshotKind kind;
+/// Number of articles (feed), or number of OPML items including the root item (OPML).
+@property (nonatomic, readonly) NSUInteger count;
+
+/// @return Snapshot data of @c feed, or @c nil if the result would exceed 4 GB.
++ (nullable NSData *)dataWithFeed:(RSParsedFeed *)feed;
+/// @return Snapshot data of @c item and all its children, or @c nil if the result would exceed 4 GB.
++ (nullable NSData *)dataWithOPML:(RSOPMLItem *)item;
+
+/// Memory-map snapshot file. Returns @c nil and sets @c error if the file can't be read or is malformed.
++ (nullable instancetype)snapshotWithContentsOfURL:(NSURL *)url error:(NSError **)error;
+/// Returns @c nil and sets @c error if @c data is not a snapshot or written by a newer version.
+- (nullable instancetype)initWithData:(NSData *)data error:(NSError **)error;
+
+/**
+ In-place access to article strings, no copy. Valid as long as the snapshot exists.
+ @return UTF-8 string (NUL terminated) or @c NULL if the field is not set or @c index is out of bounds.
+ */
+- (nullable const char *)UTF8StringForArticleAtIndex:(NSUInteger)index field:(RSXMLSnapshotArticleField)field length:(nullable NSUInteger *)length;
+- (nullable NSString *)stringForArticleAtIndex:(NSUInteger)index field:(RSXMLSnapshotArticleField)field;
+- (nullable NSDate *)datePublishedForArticleAtIndex:(NSUInteger)index;
+- (nullable NSDate *)dateModifiedForArticleAtIndex:(NSUInteger)index;
+
+/// In-place access to feed strings, no copy. @return @c NULL if the field is not set or the snapshot is not a feed.
+- (nullable const char *)UTF8StringForFeedField:(RSXMLSnapshotFeedField)field length:(nullable NSUInteger *)length;
+- (nullable NSString *)stringForFeedField:(RSXMLSnapshotFeedField)field;
+- (nullable NSDate *)feedDateParsed;
+
+/**
+ Item indices of the direct children of OPML item at @c index (root item is @c 0).
+ @return Empty range if the item has no children, @c index is out of bounds, or the snapshot is not an OPML file.
+ */
+- (NSRange)childrenOfItemAtIndex:(NSUInteger)index;
+/// @return @c 0 if @c index is out of bounds or the snapshot is not an OPML file.
+- (NSUInteger)numberOfAttributesOfItemAtIndex:(NSUInteger)index;
+/// In-place access to attribute keys, no copy. @return @c NULL if @c attribute or @c index is out of bounds.
+- (nullable const char *)UTF8KeyOfAttribute:(NSUInteger)attribute ofItemAtIndex:(NSUInteger)index;
+/// In-place access to attribute values, no copy. @return @c NULL if @c attribute or @c index is out of bounds.
+- (nullable const char *)UTF8ValueOfAttribute:(NSUInteger)attribute ofItemAtIndex:(NSUInteger)index length:(nullable NSUInteger *)length;
+/// Compares keys in place. Only the value string is created.
+- (nullable NSString *)valueForAttribute:(NSString *)key ofItemAtIndex:(NSUInteger)index;
+
+/// @return New feed with all articles. @c nil if the snapshot is not a feed.
+- (nullable RSParsedFeed *)parsedFeed;
+/// @return New root item with all children. @c nil if the snapshot is not an OPML file.
+- (nullable RSOPMLItem *)opmlItem;
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,558 @@
+//
+//  MIT License (MIT)
+//
+//  Copyright (c) 2018 Oleg Geier
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//  this software and associated documentation files (the "Software"), to deal in
+//  the Software without restriction, including without limitation the rights to
+//  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//  of the Software, and to permit persons to whom the Software is furnished to do
+//  so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#import <libkern/OSByteOrder.h>
+#import "RSXMLSnapshot.h"
+#import "RSXMLError.h"
+#import "RSParsedFeed.h"
+#import "RSParsedArticle.h"
+#import "RSOPMLItem.h"
+
+#define kSnapshotVersion 1
+#define kSnapshotNil UINT32_MAX // string offset of nil strings
+#define kSnapshotNoDate INT64_MIN
+#define kSnapshotArticleFieldCount 8
+
+// All integers are stored little-endian. All sections start 8-byte aligned.
+
+typedef struct {
+	uint32_t offset; // relative to string blob
+	uint32_t length; // without NUL
+} RSXMLSnapshotString;
+
+typedef struct {
+	char magic[4]; // "RSXS"
+	uint16_t version;
+	uint16_t kind;
+	uint32_t recordCount;
+	uint32_t recordsOffset;
+	uint32_t attributeCount;
+	uint32_t attributesOffset;
+	uint32_t stringsOffset;
+	uint32_t stringsLength;
+} RSXMLSnapshotHeader;
+
+/// Follows the header if kind is feed.
+typedef struct {
+	RSXMLSnapshotString url;
+	RSXMLSnapshotString title;
+	RSXMLSnapshotString link;
+	RSXMLSnapshotString subtitle;
+	int64_t dateParsed;
+} RSXMLSnapshotFeed;
+
+typedef struct {
+	RSXMLSnapshotString fields[kSnapshotArticleFieldCount]; // RSXMLSnapshotArticleField order
+	int64_t datePublished;
+	int64_t dateModified;
+} RSXMLSnapshotArticle;
+
+/// OPML items are stored breadth-first, so all children of an item are adjacent. Root is item 0.
+typedef struct {
+	uint32_t firstAttribute;
+	uint32_t numberOfAttributes;
+	uint32_t firstChild;
+	uint32_t numberOfChildren;
+} RSXMLSnapshotItem;
+
+typedef struct {
+	RSXMLSnapshotString key;
+	RSXMLSnapshotString value;
+} RSXMLSnapshotAttribute;
+
+
+#pragma mark - Writing
+
+
+/// Append @c str to @c blob (with terminating NUL). @return Reference in little-endian.
+static RSXMLSnapshotString appendString(NSMutableData *blob, NSString *str) {
+	const char *utf8 = str.UTF8String;
+	if (!utf8) {
+		return (RSXMLSnapshotString){ OSSwapHostToLittleInt32(kSnapshotNil), 0 };
+	}
+	size_t length = strlen(utf8);
+	uint32_t offset = (uint32_t)MIN(blob.length, kSnapshotNil - 1); // overflow is checked once at the end
+	[blob appendBytes:utf8 length:length + 1];
+	return (RSXMLSnapshotString){ OSSwapHostToLittleInt32(offset), OSSwapHostToLittleInt32((uint32_t)MIN(length, UINT32_MAX)) };
+}
+
+static int64_t millisecondsFromDate(NSDate *date) {
+	int64_t ms = (date ? (int64_t)llround(date.timeIntervalSince1970 * 1000) : kSnapshotNoDate);
+	return (int64_t)OSSwapHostToLittleInt64((uint64_t)ms);
+}
+
+static inline size_t align8(size_t value) {
+	return (value + 7) & ~(size_t)7;
+}
+
+/// Fill header, append string blob and check size limit.
+static NSData *finishSnapshot(NSMutableData *data, RSXMLSnapshotKind kind, NSUInteger recordCount, size_t recordsOffset, NSUInteger attributeCount, size_t attributesOffset, NSData *strings) {
+	size_t stringsOffset = align8(data.length);
+	if (stringsOffset + strings.length > UINT32_MAX) {
+		return nil;
+	}
+	[data setLength:stringsOffset];
+	[data appendData:strings];
+	
+	RSXMLSnapshotHeader *header = data.mutableBytes;
+	memcpy(header->magic, "RSXS", 4);
+	header->version = OSSwapHostToLittleInt16(kSnapshotVersion);
+	header->kind = OSSwapHostToLittleInt16(kind);
+	header->recordCount = OSSwapHostToLittleInt32((uint32_t)recordCount);
+	header->recordsOffset = OSSwapHostToLittleInt32((uint32_t)recordsOffset);
+	header->attributeCount = OSSwapHostToLittleInt32((uint32_t)attributeCount);
+	header->attributesOffset = OSSwapHostToLittleInt32((uint32_t)attributesOffset);
+	header->stringsOffset = OSSwapHostToLittleInt32((uint32_t)stringsOffset);
+	header->stringsLength = OSSwapHostToLittleInt32((uint32_t)strings.length);
+	return data;
+}
+
+
+#pragma mark - Snapshot
+
+
+@interface RSXMLSnapshot ()
+@property (nonatomic) NSData *data;
+@end
+
+
+@implementation RSXMLSnapshot {
+	const char *_bytes;
+	const RSXMLSnapshotFeed *_feed;
+	const RSXMLSnapshotArticle *_articles;
+	const RSXMLSnapshotItem *_items;
+	const RSXMLSnapshotAttribute *_attributes;
+	NSUInteger _attributeCount;
+	const char *_strings;
+	NSUInteger _stringsLength;
+}
+
+// docref in header
++ (NSData *)dataWithFeed:(RSParsedFeed *)feed {
+	NSArray<RSParsedArticle *> *articles = feed.articles;
+	size_t recordsOffset = sizeof(RSXMLSnapshotHeader) + sizeof(RSXMLSnapshotFeed);
+	NSMutableData *data = [NSMutableData dataWithLength:recordsOffset + articles.count * sizeof(RSXMLSnapshotArticle)];
+	NSMutableData *strings = [NSMutableData new];
+	
+	RSXMLSnapshotFeed *f = (RSXMLSnapshotFeed *)((char *)data.mutableBytes + sizeof(RSXMLSnapshotHeader));
+	f->url = appendString(strings, feed.url.absoluteString);
+	f->title = appendString(strings, feed.title);
+	f->link = appendString(strings, feed.link);
+	f->subtitle = appendString(strings, feed.subtitle);
+	f->dateParsed = millisecondsFromDate(feed.dateParsed);
+	
+	RSXMLSnapshotArticle *record = (RSXMLSnapshotArticle *)((char *)data.mutableBytes + recordsOffset);
+	for (RSParsedArticle *article in articles) {
+		record->fields[RSXMLSnapshotArticleID] = appendString(strings, article.articleID);
+		record->fields[RSXMLSnapshotArticleGuid] = appendString(strings, article.guid);
+		record->fields[RSXMLSnapshotArticleTitle] = appendString(strings, article.title);
+		record->fields[RSXMLSnapshotArticleAbstract] = appendString(strings, article.abstract);
+		record->fields[RSXMLSnapshotArticleBody] = appendString(strings, article.body);
+		record->fields[RSXMLSnapshotArticleLink] = appendString(strings, article.link);
+		record->fields[RSXMLSnapshotArticlePermalink] = appendString(strings, article.permalink);
+		record->fields[RSXMLSnapshotArticleAuthor] = appendString(strings, article.author);
+		record->datePublished = millisecondsFromDate(article.datePublished);
+		record->dateModified = millisecondsFromDate(article.dateModified);
+		record++;
+	}
+	return finishSnapshot(data, RSXMLSnapshotKindFeed, articles.count, recordsOffset, 0, 0, strings);
+}
+
+// docref in header
++ (NSData *)dataWithOPML:(RSOPMLItem *)item {
+	NSMutableArray<RSOPMLItem *> *queue = [NSMutableArray arrayWithObject:item];
+	NSMutableData *items = [NSMutableData new];
+	NSMutableData *attributes = [NSMutableData new];
+	NSMutableData *strings = [NSMutableData new];
+	NSMutableDictionary<NSString *, NSValue *> *keys = [NSMutableDictionary new]; // keys repeat a lot
+	
+	for (NSUInteger i = 0; i < queue.count; i++) {
+		NSArray<RSOPMLItem *> *children = queue[i].children;
+		NSDictionary *attribs = queue[i].attributes;
+		RSXMLSnapshotItem record = {
+			OSSwapHostToLittleInt32((uint32_t)(attributes.length / sizeof(RSXMLSnapshotAttribute))),
+			OSSwapHostToLittleInt32((uint32_t)attribs.count),
+			OSSwapHostToLittleInt32((uint32_t)queue.count),
+			OSSwapHostToLittleInt32((uint32_t)children.count),
+		};
+		[items appendBytes:&record length:sizeof(RSXMLSnapshotItem)];
+		if (children.count > 0) {
+			[queue addObjectsFromArray:children];
+		}
+		for (NSString *key in attribs) {
+			RSXMLSnapshotAttribute attribute;
+			NSValue *cached = keys[key];
+			if (cached) {
+				[cached getValue:&attribute.key];
+			} else {
+				attribute.key = appendString(strings, key);
+				keys[key] = [NSValue valueWithBytes:&attribute.key objCType:@encode(RSXMLSnapshotString)];
+			}
+			id value = attribs[key];
+			attribute.value = appendString(strings, ([value isKindOfClass:[NSString class]] ? value : [NSString stringWithFormat:@"%@", value]));
+			[attributes appendBytes:&attribute length:sizeof(RSXMLSnapshotAttribute)];
+		}
+	}
+	size_t recordsOffset = sizeof(RSXMLSnapshotHeader);
+	size_t attributesOffset = recordsOffset + items.length;
+	if (attributesOffset + attributes.length > UINT32_MAX) {
+		return nil;
+	}
+	NSMutableData *data = [NSMutableData dataWithLength:recordsOffset];
+	[data appendData:items];
+	[data appendData:attributes];
+	return finishSnapshot(data, RSXMLSnapshotKindOPML, queue.count, recordsOffset,
+						  attributes.length / sizeof(RSXMLSnapshotAttribute), attributesOffset, strings);
+}
+
+// docref in header
++ (instancetype)snapshotWithContentsOfURL:(NSURL *)url error:(NSError **)error {
+	NSData *data = [NSData dataWithContentsOfURL:url options:NSDataReadingMappedAlways error:error];
+	if (!data) {
+		return nil;
+	}
+	return [[self alloc] initWithData:data error:error];
+}
+
+// docref in header
+- (instancetype)initWithData:(NSData *)data error:(NSError **)error {
+	self = [super init];
+	if (self) {
+		if (((uintptr_t)data.bytes & 7) != 0) { // records are read in place, they must be aligned
+			data = [NSData dataWithBytes:data.bytes length:data.length];
+		}
+		_data = data;
+		RSXMLError code = [self validateHeader];
+		if (code != 0) {
+			if (error) *error = RSXMLMakeError(code, nil);
+			return nil;
+		}
+	}
+	return self;
+}
+
+/// Check that all tables are within bounds. @return Error code or @c 0 if valid.
+- (RSXMLError)validateHeader {
+	const NSUInteger total = _data.length;
+	if (total < sizeof(RSXMLSnapshotHeader)) {
+		return RSXMLErrorSnapshotMalformed;
+	}
+	_bytes = _data.bytes;
+	const RSXMLSnapshotHeader *header = (const RSXMLSnapshotHeader *)_bytes;
+	if (memcmp(header->magic, "RSXS", 4) != 0) {
+		return RSXMLErrorSnapshotMalformed;
+	}
+	if (OSSwapLittleToHostInt16(header->version) != kSnapshotVersion) {
+		return RSXMLErrorSnapshotVersion;
+	}
+	_kind = OSSwapLittleToHostInt16(header->kind);
+	_count = OSSwapLittleToHostInt32(header->recordCount);
+	uint64_t recordsOffset = OSSwapLittleToHostInt32(header->recordsOffset);
+	uint64_t stringsOffset = OSSwapLittleToHostInt32(header->stringsOffset);
+	_stringsLength = OSSwapLittleToHostInt32(header->stringsLength);
+	if (recordsOffset % 8 != 0 || stringsOffset + _stringsLength > total) {
+		return RSXMLErrorSnapshotMalformed;
+	}
+	_strings = _bytes + stringsOffset;
+	
+	switch (_kind) {
+		case RSXMLSnapshotKindFeed:
+			if (recordsOffset < sizeof(RSXMLSnapshotHeader) + sizeof(RSXMLSnapshotFeed) ||
+				recordsOffset + (uint64_t)_count * sizeof(RSXMLSnapshotArticle) > total) {
+				return RSXMLErrorSnapshotMalformed;
+			}
+			_feed = (const RSXMLSnapshotFeed *)(_bytes + sizeof(RSXMLSnapshotHeader));
+			_articles = (const RSXMLSnapshotArticle *)(_bytes + recordsOffset);
+			return 0;
+		case RSXMLSnapshotKindOPML: {
+			uint64_t attributesOffset = OSSwapLittleToHostInt32(header->attributesOffset);
+			_attributeCount = OSSwapLittleToHostInt32(header->attributeCount);
+			if (_count == 0 || attributesOffset % 8 != 0 ||
+				recordsOffset + (uint64_t)_count * sizeof(RSXMLSnapshotItem) > total ||
+				attributesOffset + (uint64_t)_attributeCount * sizeof(RSXMLSnapshotAttribute) > total) {
+				return RSXMLErrorSnapshotMalformed;
+			}
+			_items = (const RSXMLSnapshotItem *)(_bytes + recordsOffset);
+			_attributes = (const RSXMLSnapshotAttribute *)(_bytes + attributesOffset);
+			return ([self validateItemTree] ? 0 : RSXMLErrorSnapshotMalformed);
+		}
+	}
+	return RSXMLErrorSnapshotMalformed;
+}
+
+
+/**
+ Items are stored breadth-first. Thus the children of all items, in item order, must form one
+ gapless sequence starting at item 1. This guarantees that every item except root has exactly
+ one parent which is stored before it (no cycles, no shared subtrees).
+ */
+- (BOOL)validateItemTree {
+	uint64_t nextChild = 1;
+	for (NSUInteger i = 0; i < _count; i++) {
+		const RSXMLSnapshotItem *record = &_items[i];
+		uint64_t firstAttribute = OSSwapLittleToHostInt32(record->firstAttribute);
+		uint64_t numberOfAttributes = OSSwapLittleToHostInt32(record->numberOfAttributes);
+		uint32_t numberOfChildren = OSSwapLittleToHostInt32(record->numberOfChildren);
+		if (firstAttribute + numberOfAttributes > _attributeCount) {
+			return NO;
+		}
+		if (i > 0 && nextChild <= i) {
+			return NO; // item without parent
+		}
+		if (numberOfChildren > 0) {
+			if (OSSwapLittleToHostInt32(record->firstChild) != nextChild) {
+				return NO;
+			}
+			nextChild += numberOfChildren;
+		}
+	}
+	return (nextChild == _count);
+}
+
+
+#pragma mark - In-place Access
+
+
+/// @return Pointer into string blob or @c NULL if @c nil or out of bounds.
+- (const char *)UTF8String:(RSXMLSnapshotString)ref length:(NSUInteger *)length {
+	uint32_t offset = OSSwapLittleToHostInt32(ref.offset);
+	uint32_t len = OSSwapLittleToHostInt32(ref.length);
+	if (offset == kSnapshotNil || (uint64_t)offset + len >= _stringsLength || _strings[offset + len] != '\0') {
+		return NULL;
+	}
+	if (length) *length = len;
+	return _strings + offset;
+}
+
+- (NSString *)string:(RSXMLSnapshotString)ref {
+	NSUInteger length = 0;
+	const char *str = [self UTF8String:ref length:&length];
+	if (!str) {
+		return nil;
+	}
+	return [[NSString alloc] initWithBytes:str length:length encoding:NSUTF8StringEncoding];
+}
+
+static NSDate *dateFromMilliseconds(int64_t value) {
+	int64_t ms = (int64_t)OSSwapLittleToHostInt64((uint64_t)value);
+	if (ms == kSnapshotNoDate) {
+		return nil;
+	}
+	return [NSDate dateWithTimeIntervalSince1970:ms / 1000.0];
+}
+
+/// @return Article record or @c NULL if not a feed or @c index is out of bounds.
+- (const RSXMLSnapshotArticle *)articleAtIndex:(NSUInteger)index {
+	if (!_articles || index >= _count) {
+		return NULL;
+	}
+	return &_articles[index];
+}
+
+// docref in header
+- (const char *)UTF8StringForArticleAtIndex:(NSUInteger)index field:(RSXMLSnapshotArticleField)field length:(NSUInteger *)length {
+	const RSXMLSnapshotArticle *article = [self articleAtIndex:index];
+	if (!article || field >= kSnapshotArticleFieldCount) {
+		return NULL;
+	}
+	return [self UTF8String:article->fields[field] length:length];
+}
+
+// docref in header
+- (NSString *)stringForArticleAtIndex:(NSUInteger)index field:(RSXMLSnapshotArticleField)field {
+	const RSXMLSnapshotArticle *article = [self articleAtIndex:index];
+	if (!article || field >= kSnapshotArticleFieldCount) {
+		return nil;
+	}
+	return [self string:article->fields[field]];
+}
+
+// docref in header
+- (NSDate *)datePublishedForArticleAtIndex:(NSUInteger)index {
+	const RSXMLSnapshotArticle *article = [self articleAtIndex:index];
+	return (article ? dateFromMilliseconds(article->datePublished) : nil);
+}
+
+// docref in header
+- (NSDate *)dateModifiedForArticleAtIndex:(NSUInteger)index {
+	const RSXMLSnapshotArticle *article = [self articleAtIndex:index];
+	return (article ? dateFromMilliseconds(article->dateModified) : nil);
+}
+
+/// @return Reference of feed @c field or @c NULL if not a feed.
+- (const RSXMLSnapshotString *)feedField:(RSXMLSnapshotFeedField)field {
+	if (!_feed) {
+		return NULL;
+	}
+	switch (field) {
+		case RSXMLSnapshotFeedURL:      return &_feed->url;
+		case RSXMLSnapshotFeedTitle:    return &_feed->title;
+		case RSXMLSnapshotFeedLink:     return &_feed->link;
+		case RSXMLSnapshotFeedSubtitle: return &_feed->subtitle;
+	}
+	return NULL;
+}
+
+// docref in header
+- (const char *)UTF8StringForFeedField:(RSXMLSnapshotFeedField)field length:(NSUInteger *)length {
+	const RSXMLSnapshotString *ref = [self feedField:field];
+	return (ref ? [self UTF8String:*ref length:length] : NULL);
+}
+
+// docref in header
+- (NSString *)stringForFeedField:(RSXMLSnapshotFeedField)field {
+	const RSXMLSnapshotString *ref = [self feedField:field];
+	return (ref ? [self string:*ref] : nil);
+}
+
+// docref in header
+- (NSDate *)feedDateParsed {
+	return (_feed ? dateFromMilliseconds(_feed->dateParsed) : nil);
+}
+
+/// @return Item record or @c NULL if not an OPML file or @c index is out of bounds.
+- (const RSXMLSnapshotItem *)itemAtIndex:(NSUInteger)index {
+	if (!_items || index >= _count) {
+		return NULL;
+	}
+	return &_items[index];
+}
+
+// docref in header
+- (NSRange)childrenOfItemAtIndex:(NSUInteger)index {
+	const RSXMLSnapshotItem *item = [self itemAtIndex:index];
+	if (!item || item->numberOfChildren == 0) {
+		return NSMakeRange(0, 0);
+	}
+	return NSMakeRange(OSSwapLittleToHostInt32(item->firstChild), OSSwapLittleToHostInt32(item->numberOfChildren));
+}
+
+// docref in header
+- (NSUInteger)numberOfAttributesOfItemAtIndex:(NSUInteger)index {
+	const RSXMLSnapshotItem *item = [self itemAtIndex:index];
+	return (item ? OSSwapLittleToHostInt32(item->numberOfAttributes) : 0);
+}
+
+/// @return Attribute record or @c NULL if @c attribute or @c index is out of bounds. Ranges are checked in @c validateItemTree.
+- (const RSXMLSnapshotAttribute *)attribute:(NSUInteger)attribute ofItemAtIndex:(NSUInteger)index {
+	const RSXMLSnapshotItem *item = [self itemAtIndex:index];
+	if (!item || attribute >= OSSwapLittleToHostInt32(item->numberOfAttributes)) {
+		return NULL;
+	}
+	return &_attributes[OSSwapLittleToHostInt32(item->firstAttribute) + attribute];
+}
+
+// docref in header
+- (const char *)UTF8KeyOfAttribute:(NSUInteger)attribute ofItemAtIndex:(NSUInteger)index {
+	const RSXMLSnapshotAttribute *attr = [self attribute:attribute ofItemAtIndex:index];
+	return (attr ? [self UTF8String:attr->key length:NULL] : NULL);
+}
+
+// docref in header
+- (const char *)UTF8ValueOfAttribute:(NSUInteger)attribute ofItemAtIndex:(NSUInteger)index length:(NSUInteger *)length {
+	const RSXMLSnapshotAttribute *attr = [self attribute:attribute ofItemAtIndex:index];
+	return (attr ? [self UTF8String:attr->value length:length] : NULL);
+}
+
+// docref in header
+- (NSString *)valueForAttribute:(NSString *)key ofItemAtIndex:(NSUInteger)index {
+	const char *utf8Key = key.UTF8String;
+	NSUInteger count = [self numberOfAttributesOfItemAtIndex:index];
+	for (NSUInteger i = 0; i < count && utf8Key; i++) {
+		const RSXMLSnapshotAttribute *attr = [self attribute:i ofItemAtIndex:index];
+		const char *k = [self UTF8String:attr->key length:NULL];
+		if (k && strcmp(k, utf8Key) == 0) {
+			return [self string:attr->value];
+		}
+	}
+	return nil;
+}
+
+
+#pragma mark - Materialize
+
+
+// docref in header
+- (RSParsedFeed *)parsedFeed {
+	if (_kind != RSXMLSnapshotKindFeed) {
+		return nil;
+	}
+	NSString *url = [self string:_feed->url];
+	NSURL *feedURL = (url ? [NSURL URLWithString:url] : nil);
+	NSDate *dateParsed = dateFromMilliseconds(_feed->dateParsed);
+	if (!feedURL || !dateParsed) {
+		return nil;
+	}
+	RSParsedFeed *feed = [[RSParsedFeed alloc] initWithURL:feedURL dateParsed:dateParsed];
+	feed.title = [self string:_feed->title];
+	feed.link = [self string:_feed->link];
+	feed.subtitle = [self string:_feed->subtitle];
+	
+	for (NSUInteger i = 0; i < _count; i++) {
+		const RSXMLSnapshotArticle *record = &_articles[i];
+		RSParsedArticle *article = [feed appendNewArticle];
+		article.guid = [self string:record->fields[RSXMLSnapshotArticleGuid]];
+		article.title = [self string:record->fields[RSXMLSnapshotArticleTitle]];
+		article.abstract = [self string:record->fields[RSXMLSnapshotArticleAbstract]];
+		article.body = [self string:record->fields[RSXMLSnapshotArticleBody]];
+		article.link = [self string:record->fields[RSXMLSnapshotArticleLink]];
+		article.permalink = [self string:record->fields[RSXMLSnapshotArticlePermalink]];
+		article.author = [self string:record->fields[RSXMLSnapshotArticleAuthor]];
+		article.datePublished = dateFromMilliseconds(record->datePublished);
+		article.dateModified = dateFromMilliseconds(record->dateModified);
+	}
+	return feed;
+}
+
+// docref in header
+- (RSOPMLItem *)opmlItem {
+	if (_kind != RSXMLSnapshotKindOPML) {
+		return nil;
+	}
+	// create all items first, then link them. No recursion, the tree can be arbitrarily deep.
+	NSMutableArray<RSOPMLItem *> *items = [NSMutableArray arrayWithCapacity:_count];
+	for (NSUInteger index = 0; index < _count; index++) {
+		const RSXMLSnapshotItem *record = &_items[index];
+		NSUInteger firstAttribute = OSSwapLittleToHostInt32(record->firstAttribute);
+		NSUInteger numberOfAttributes = OSSwapLittleToHostInt32(record->numberOfAttributes);
+		NSMutableDictionary *attribs = [NSMutableDictionary dictionaryWithCapacity:numberOfAttributes];
+		for (NSUInteger i = firstAttribute; i < firstAttribute + numberOfAttributes; i++) {
+			NSString *key = [self string:_attributes[i].key];
+			NSString *value = [self string:_attributes[i].value];
+			if (key && value) {
+				attribs[key] = value;
+			}
+		}
+		[items addObject:[RSOPMLItem itemWithAttributes:attribs]];
+	}
+	// each item has exactly one parent, see validateItemTree
+	for (NSUInteger index = 0; index < _count; index++) {
+		NSRange children = [self childrenOfItemAtIndex:index];
+		for (NSUInteger i = children.location; i < NSMaxRange(children); i++) {
+			[items[index] addChild:items[i]];
+		}
+	}
+	return items.firstObject;
+}
+
+@end
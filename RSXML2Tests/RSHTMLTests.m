@@ -137,6 +137,55 @@
 	}];
 }
 
+- (void)compareFastHeadScan:(RSXMLData *)xmlData expectFallback:(BOOL)fallback {
+	RSHTMLMetadata *expected = [[RSHTMLMetadataParser parserWithXMLData:xmlData] parseSync:nil];
+	RSHTMLMetadataParser *parser = [RSHTMLMetadataParser parserWithXMLData:xmlData];
+	parser.fastHeadScan = YES;
+	NSError *error;
+	RSHTMLMetadata *metadata = [parser parseSync:&error];
+	XCTAssertNil(error);
+	XCTAssertEqual(parser.fastScanFailed, fallback, @"%@", xmlData.url);
+	XCTAssertEqualObjects(metadata.faviconLink, expected.faviconLink);
+	XCTAssertEqual(metadata.feedLinks.count, expected.feedLinks.count);
+	XCTAssertEqualObjects(metadata.feedLinks.firstObject.link, expected.feedLinks.firstObject.link);
+	XCTAssertEqualObjects(metadata.feedLinks.firstObject.title, expected.feedLinks.firstObject.title);
+	XCTAssertEqual(metadata.iconLinks.count, expected.iconLinks.count);
+	XCTAssertEqualObjects(metadata.iconLinks.lastObject.link, expected.iconLinks.lastObject.link);
+}
+
+- (void)testFastHeadScan {
+
+	NSDictionary *pages = @{@"DaringFireball": @"http://daringfireball.net/", @"furbo": @"http://furbo.org/",
+							@"inessential": @"http://inessential.com/", @"sixcolors": @"https://sixcolors.com/"};
+	for (NSString *name in pages) {
+		[self compareFastHeadScan:[self xmlData:name urlString:pages[name]] expectFallback:NO];
+	}
+	
+	// malformed markup must fall back to libxml
+	NSMutableString *manyAttributes = [NSMutableString stringWithString:@"<link rel=\"alternate\" type=\"application/rss+xml\" href=\"/feed\""];
+	for (int i = 0; i < 16; i++) {
+		[manyAttributes appendFormat:@" data-%d=\"%d\"", i, i];
+	}
+	[manyAttributes appendString:@">"];
+	const char *latin1 = "<html><head><link rel=\"alternate\" type=\"application/rss+xml\" title=\"Caf\xE9\" href=\"/feed\"></head></html>";
+	NSArray<NSData*> *malformed = @[
+		[@"<html><head><link rel=\"icon\" href=\"/a.ico\"><link rel=\"shortcut icon href=/b.ico></head></html>" dataUsingEncoding:NSUTF8StringEncoding],
+		[[NSString stringWithFormat:@"<html><head><link rel=\"icon\" href=\"/a.ico\">%@</head></html>", manyAttributes] dataUsingEncoding:NSUTF8StringEncoding],
+		[NSData dataWithBytes:latin1 length:strlen(latin1)],
+	];
+	for (NSData *data in malformed) {
+		[self compareFastHeadScan:[[RSXMLData alloc] initWithData:data url:[NSURL URLWithString:@"https://example.com/"]] expectFallback:YES];
+	}
+	
+	RSXMLData *xmlData = [self xmlData:@"sixcolors" urlString:@"https://sixcolors.com/"];
+	RSHTMLMetadataParser *parser = [RSHTMLMetadataParser parserWithXMLData:xmlData];
+	parser.fastHeadScan = YES;
+	[self measureBlock:^{
+		for (int i = 0; i < 10; i++)
+			[parser parseSync:nil];
+	}];
+}
+
 #pragma mark - Links
 
 - (void)testSixColorsLinks {
@@ -123,6 +123,75 @@
 	}];
 }
 
+- (void)testSnapshot {
+	RSXMLData<RSOPMLParser*> *xmlData = [self xmlFile:@"Subs" extension:@"opml"];
+	RSOPMLItem *document = [[xmlData getParser] parseSync:nil];
+	NSData *data = [RSXMLSnapshot dataWithOPML:document];
+	XCTAssertNotNil(data);
+	
+	NSError *error;
+	RSXMLSnapshot *snapshot = [[RSXMLSnapshot alloc] initWithData:data error:&error];
+	XCTAssertNil(error);
+	XCTAssertEqual(snapshot.kind, RSXMLSnapshotKindOPML);
+	XCTAssertNil(snapshot.parsedFeed);
+	RSOPMLItem *restored = snapshot.opmlItem;
+	XCTAssertEqualObjects(restored.displayName, @"Subs");
+	XCTAssertEqualObjects(restored.children.lastObject.children.lastObject.displayName, @"Gerrold");
+	[self compareOPMLItem:restored with:document];
+	[self checkStructureForOPMLItem:restored isRoot:YES];
+	
+	// in-place access
+	NSRange children = [snapshot childrenOfItemAtIndex:0];
+	XCTAssertEqual(children.location, 1u);
+	XCTAssertEqual(children.length, document.children.count);
+	NSUInteger last = NSMaxRange([snapshot childrenOfItemAtIndex:NSMaxRange(children) - 1]) - 1;
+	XCTAssertEqualObjects([snapshot valueForAttribute:OPMLTextKey ofItemAtIndex:last], @"Gerrold");
+	XCTAssertEqual([snapshot numberOfAttributesOfItemAtIndex:last], document.children.lastObject.children.lastObject.attributes.count);
+	XCTAssertNotEqual([snapshot UTF8KeyOfAttribute:0 ofItemAtIndex:last], NULL);
+	XCTAssertEqual([snapshot UTF8ValueOfAttribute:99 ofItemAtIndex:last length:NULL], NULL);
+	XCTAssertEqual([snapshot childrenOfItemAtIndex:snapshot.count].length, 0u);
+	
+	// second item claims the children of root (overlapping ranges)
+	NSMutableData *shared = [data mutableCopy];
+	uint32_t *secondItem = (uint32_t *)((char *)shared.mutableBytes + 32 + 16);
+	secondItem[2] = NSSwapHostIntToLittle(1);
+	secondItem[3] = NSSwapHostIntToLittle(1);
+	XCTAssertNil([[RSXMLSnapshot alloc] initWithData:shared error:&error]);
+	XCTAssertEqual(error.code, RSXMLErrorSnapshotMalformed);
+	
+	[self measureBlock:^{
+		[[[RSXMLSnapshot alloc] initWithData:data error:nil] opmlItem];
+	}];
+}
+
+- (void)testSnapshotDeepNesting {
+	RSOPMLItem *root = [RSOPMLItem itemWithAttributes:@{OPMLTextKey: @"0"}];
+	RSOPMLItem *parent = root;
+	for (int i = 1; i < 5000; i++) {
+		RSOPMLItem *child = [RSOPMLItem itemWithAttributes:@{OPMLTextKey: [NSString stringWithFormat:@"%d", i]}];
+		[parent addChild:child];
+		parent = child;
+	}
+	RSXMLSnapshot *snapshot = [[RSXMLSnapshot alloc] initWithData:[RSXMLSnapshot dataWithOPML:root] error:nil];
+	XCTAssertEqual(snapshot.count, 5000u);
+	RSOPMLItem *item = snapshot.opmlItem;
+	NSUInteger depth = 0;
+	while (item.children.count == 1) {
+		item = item.children.firstObject;
+		depth++;
+	}
+	XCTAssertEqual(depth, 4999u);
+	XCTAssertEqualObjects(item.displayName, @"4999");
+}
+
+- (void)compareOPMLItem:(RSOPMLItem *)item with:(RSOPMLItem *)other {
+	XCTAssertEqualObjects(item.attributes, other.attributes);
+	XCTAssertEqual(item.children.count, other.children.count);
+	for (NSUInteger i = 0; i < MIN(item.children.count, other.children.count); i++) {
+		[self compareOPMLItem:item.children[i] with:other.children[i]];
+	}
+}
+
 - (void)checkStructureForOPMLItem:(RSOPMLItem *)item isRoot:(BOOL)root {
 
 	if (!root) {
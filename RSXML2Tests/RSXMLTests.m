@@ -24,6 +24,54 @@
 
 #import <XCTest/XCTest.h>
 @import RSXML2;
+#import <RSXML2/RSSAXParser.h>
+
+/// Minimal delegate to measure the raw cost of SAX event dispatch.
+@interface RSSAXEventCounter : NSObject <RSSAXParserDelegate>
+@property (nonatomic, assign) NSUInteger numberOfEvents;
+@end
+
+@implementation RSSAXEventCounter
++ (BOOL)isHTMLParser { return NO; }
+- (void)saxParser:(RSSAXParser *)SAXParser XMLStartElement:(const unsigned char *)localName prefix:(const unsigned char *)prefix uri:(const unsigned char *)uri numberOfNamespaces:(NSInteger)numberOfNamespaces namespaces:(const unsigned char **)namespaces numberOfAttributes:(NSInteger)numberOfAttributes numberDefaulted:(int)numberDefaulted attributes:(const unsigned char **)attributes {
+	self.numberOfEvents++;
+}
+- (void)saxParser:(RSSAXParser *)SAXParser XMLEndElement:(const unsigned char *)localName prefix:(const unsigned char *)prefix uri:(const unsigned char *)uri {
+	self.numberOfEvents++;
+}
+- (void)saxParser:(RSSAXParser *)SAXParser XMLCharactersFound:(const unsigned char *)characters length:(NSUInteger)length {
+	self.numberOfEvents++;
+}
+@end
+
+
+/// Custom decoding must be used regardless of @c lazyDecoding.
+@interface RSUppercaseAtomParser : RSAtomParser
+@end
+
+@implementation RSUppercaseAtomParser
+- (NSString *)decodeHTMLEntities:(NSString *)str {
+	return [super decodeHTMLEntities:str].uppercaseString;
+}
+@end
+
+
+/// Signals @c parsingStarted after the parser polled the token a few times (i.e., parsing is underway).
+@interface RSPollingCancelToken : RSXMLCancelToken
+@property (nonatomic, strong) dispatch_semaphore_t parsingStarted;
+@end
+
+@implementation RSPollingCancelToken {
+	NSUInteger _polls;
+}
+- (BOOL)isCanceled {
+	if (++_polls == 100) {
+		dispatch_semaphore_signal(self.parsingStarted);
+	}
+	return [super isCanceled];
+}
+@end
+
 
 @interface RSXMLTests : XCTestCase
 
@@ -72,6 +120,27 @@
 	return [xmlData getParser];
 }
 
+/// Assert that both articles carry the same content. Used to compare parser options against the default parse.
+- (void)compareArticle:(RSParsedArticle*)a with:(RSParsedArticle*)b {
+	XCTAssertEqualObjects(a.articleID, b.articleID);
+	XCTAssertEqualObjects(a.title, b.title);
+	XCTAssertEqualObjects(a.abstract, b.abstract);
+	XCTAssertEqualObjects(a.body, b.body);
+	XCTAssertEqualObjects(a.link, b.link);
+	XCTAssertEqualObjects(a.author, b.author);
+	XCTAssertEqualObjects(a.datePublished, b.datePublished);
+	XCTAssertEqualObjects(a.dateModified, b.dateModified);
+}
+
+- (void)compareFeed:(RSParsedFeed*)a with:(RSParsedFeed*)b {
+	XCTAssertEqualObjects(a.title, b.title);
+	XCTAssertEqualObjects(a.link, b.link);
+	XCTAssertEqual(a.articles.count, b.articles.count);
+	for (NSUInteger i = 0; i < MIN(a.articles.count, b.articles.count); i++) {
+		[self compareArticle:a.articles[i] with:b.articles[i]];
+	}
+}
+
 #pragma mark - Completeness Tests
 
 - (void)testAsync {
@@ -287,6 +356,355 @@
 	XCTAssertEqualObjects(error.localizedDescription, @"Opening and ending tag mismatch: channel line 10 and rss");
 }
 
+- (void)testErrorLimit {
+	NSMutableString *xml = [NSMutableString stringWithString:@"<?xml version=\"1.0\"?><rss version=\"2.0\"><channel><title>broken</title>"];
+	for (int i = 0; i < 20; i++) {
+		[xml appendFormat:@"<item><title>item %d</titel><link>http://example.org/%d</link></item>\n", i, i];
+	}
+	[xml appendString:@"</channel></rss>"];
+	RSXMLData *xmlData = [[RSXMLData alloc] initWithData:[xml dataUsingEncoding:NSUTF8StringEncoding] url:[NSURL URLWithString:@"http://example.org/feed"]];
+	RSFeedParser *parser = [xmlData getParser];
+	NSError *error = nil;
+	RSParsedFeed *parsedFeed = [parser parseSync:&error];
+	XCTAssertEqual(error.code, 76); // first fatal error
+	XCTAssertEqual(parser.allParsingErrors.count, 20u); // one per item
+	XCTAssertEqual(parser.allParsingErrors.firstObject.code, 76);
+	XCTAssertEqual(parsedFeed.articles.count, 20u); // recovered
+	
+	RSFeedParser *limited = [xmlData getParser];
+	limited.maxErrorCount = 5;
+	RSParsedFeed *partialFeed = [limited parseSync:&error];
+	XCTAssertEqual(error.code, RSXMLErrorTooManyErrors);
+	XCTAssertEqual(limited.allParsingErrors.count, 6u);
+	XCTAssertGreaterThan(partialFeed.articles.count, 0u); // partial result
+	XCTAssertLessThan(partialFeed.articles.count, parsedFeed.articles.count);
+}
+
+- (void)testCancelToken {
+	RSXMLData *xmlData = [self xmlFile:@"DaringFireball" extension:@"atom"];
+	RSFeedParser *parser = [xmlData getParser];
+	parser.cancelToken = [RSXMLCancelToken new];
+	[parser.cancelToken cancel];
+	NSError *error = nil;
+	RSParsedFeed *parsedFeed = [parser parseSync:&error];
+	XCTAssertEqual(error.code, RSXMLErrorCanceled);
+	XCTAssertNotNil(parsedFeed);
+	XCTAssertEqual(parsedFeed.articles.count, 0u);
+}
+
+- (void)testCancelTokenFromOtherThread {
+	NSMutableString *xml = [NSMutableString stringWithString:@"<?xml version=\"1.0\"?><rss version=\"2.0\"><channel><title>large</title>"];
+	for (int i = 0; i < 100000; i++) {
+		[xml appendFormat:@"<item><title>item %d</title><link>http://example.org/%d</link><description>text</description></item>\n", i, i];
+	}
+	[xml appendString:@"</channel></rss>"];
+	RSXMLData *xmlData = [[RSXMLData alloc] initWithData:[xml dataUsingEncoding:NSUTF8StringEncoding] url:[NSURL URLWithString:@"http://example.org/feed"]];
+	RSFeedParser *parser = [xmlData getParser];
+	RSPollingCancelToken *token = [RSPollingCancelToken new];
+	token.parsingStarted = dispatch_semaphore_create(0);
+	parser.cancelToken = token;
+	dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+		dispatch_semaphore_wait(token.parsingStarted, DISPATCH_TIME_FOREVER);
+		[token cancel];
+	});
+	NSError *error = nil;
+	RSParsedFeed *parsedFeed = [parser parseSync:&error];
+	XCTAssertEqual(error.code, RSXMLErrorCanceled);
+	XCTAssertGreaterThan(parsedFeed.articles.count, 0u); // partial result
+	XCTAssertLessThan(parsedFeed.articles.count, 100000u);
+}
+
+- (void)testTimeout {
+	RSXMLData *xmlData = [self xmlFile:@"DaringFireball" extension:@"atom"];
+	RSFeedParser *parser = [xmlData getParser];
+	parser.timeout = 1e-9;
+	NSError *error = nil;
+	RSParsedFeed *parsedFeed = [parser parseSync:&error];
+	XCTAssertEqual(error.code, RSXMLErrorTimeout);
+	XCTAssertLessThan(parsedFeed.articles.count, 47u); // partial result
+	
+	parser = [xmlData getParser];
+	parser.timeout = DBL_MAX; // no overflow
+	parsedFeed = [parser parseSync:&error];
+	XCTAssertNil(error);
+	XCTAssertEqual(parsedFeed.articles.count, 47u);
+}
+
+- (void)testArchiveReader {
+	NSArray *files = @[@"OneFootTsunami", @"atom", @"scriptingNews", @"rss", @"manton", @"rss", @"DaringFireball", @"atom"];
+	NSMutableData *archive = [NSMutableData new];
+	for (NSUInteger i = 0; i < files.count; i += 2) {
+		RSXMLData *xmlData = [self xmlFile:files[i] extension:files[i + 1]];
+		NSData *url = [xmlData.url.absoluteString dataUsingEncoding:NSUTF8StringEncoding];
+		uint32_t lengths[2] = { NSSwapHostIntToLittle((uint32_t)url.length), NSSwapHostIntToLittle((uint32_t)xmlData.data.length) };
+		[archive appendBytes:lengths length:sizeof(lengths)];
+		[archive appendData:url];
+		[archive appendData:xmlData.data];
+	}
+	NSError *error = nil;
+	RSXMLArchiveReader *reader = [[RSXMLArchiveReader alloc] initWithData:archive error:&error];
+	XCTAssertNil(error);
+	XCTAssertEqual(reader.count, 4u);
+	
+	NSMutableArray *titles = [NSMutableArray new];
+	__block NSUInteger expectedIndex = 0;
+	RSXMLArchiveStatistics *stats = [reader parseConcurrently:^(NSUInteger index, RSXMLData *xmlData, RSParsedFeed *document, NSError *err) {
+		XCTAssertEqual(index, expectedIndex++);
+		XCTAssertNil(err);
+		[titles addObject:document.title];
+	}];
+	XCTAssertEqualObjects(titles, (@[@"One Foot Tsunami", @"Scripting News", @"Manton Reece", @"Daring Fireball"]));
+	XCTAssertEqual(stats.numberOfRecords, 4u);
+	XCTAssertEqual(stats.numberOfFailures, 0u);
+	XCTAssertEqual(stats.numberOfRecoveredErrors, 0u);
+	
+	// recovered parse error is not a failure, a record without parser is
+	NSMutableData *mixed = [NSMutableData new];
+	for (NSData *body in @[[self xmlFile:@"broken" extension:@"rss"].data, [@"not a feed" dataUsingEncoding:NSUTF8StringEncoding]]) {
+		uint32_t lengths[2] = { 0, NSSwapHostIntToLittle((uint32_t)body.length) };
+		[mixed appendBytes:lengths length:sizeof(lengths)];
+		[mixed appendData:body];
+	}
+	stats = [[[RSXMLArchiveReader alloc] initWithData:mixed error:nil] parseConcurrently:^(NSUInteger index, RSXMLData *xmlData, id document, NSError *err) {
+		XCTAssertNotNil(err);
+		XCTAssertEqual(document != nil, index == 0);
+	}];
+	XCTAssertEqual(stats.numberOfFailures, 1u);
+	XCTAssertEqual(stats.numberOfRecoveredErrors, 1u);
+	
+	[archive setLength:archive.length - 1];
+	reader = [[RSXMLArchiveReader alloc] initWithData:archive error:&error];
+	XCTAssertNil(reader);
+	XCTAssertEqual(error.code, RSXMLErrorArchiveMalformed);
+}
+
+- (void)testInternStrings {
+	NSString *a = RSXMLInternedString("text/html", 9);
+	XCTAssertEqualObjects(a, @"text/html");
+	XCTAssertEqual(a, RSXMLInternedString("text/html", 9)); // same instance
+	XCTAssertNil(RSXMLInternedString("\xff\xfe", 2)); // invalid UTF-8
+	
+	RSXMLData *xmlData = [self xmlFile:@"KatieFloyd" extension:@"rss"];
+	RSFeedParser *parser = [xmlData getParser];
+	parser.internStrings = YES;
+	NSError *error = nil;
+	RSParsedFeed *parsedFeed = [parser parseSync:&error];
+	XCTAssertNil(error);
+	[self compareFeed:parsedFeed with:[[xmlData getParser] parseSync:nil]];
+	// all 20 items have the same <dc:creator>
+	XCTAssertEqual(parsedFeed.articles.count, 20u);
+	for (RSParsedArticle *article in parsedFeed.articles) {
+		XCTAssertEqual(article.author, parsedFeed.articles.firstObject.author); // same instance
+	}
+	[self measureBlock:^{
+		RSFeedParser *p = [xmlData getParser];
+		p.internStrings = YES;
+		[p parseSync:nil];
+	}];
+}
+
+- (void)testArena {
+	RSXMLData *xmlData = [self xmlFile:@"DaringFireball" extension:@"atom"];
+	RSFeedParser *parser = [xmlData getParser];
+	parser.useArena = YES;
+	NSError *error = nil;
+	RSParsedFeed *parsedFeed = [parser parseSync:&error];
+	XCTAssertNil(error);
+	XCTAssertGreaterThan(parser.memoryHighWaterMark, 0u);
+	// libxml memory allocated outside of an arena must stay intact
+	RSFeedParser *plain = [xmlData getParser];
+	[self compareFeed:parsedFeed with:[plain parseSync:nil]];
+	XCTAssertEqual(plain.memoryHighWaterMark, 0u);
+	// libxml error message is arena memory
+	RSFeedParser *broken = [[self xmlFile:@"broken" extension:@"rss"] getParser];
+	broken.useArena = YES;
+	[broken parseSync:&error];
+	XCTAssertEqualObjects(error.localizedDescription, @"Opening and ending tag mismatch: channel line 10 and rss");
+	[self measureBlock:^{
+		RSFeedParser *p = [xmlData getParser];
+		p.useArena = YES;
+		[p parseSync:nil];
+	}];
+}
+
+- (void)testArenaConcurrent {
+	NSArray<RSXMLData*> *files = @[[self xmlFile:@"DaringFireball" extension:@"atom"], [self xmlFile:@"KatieFloyd" extension:@"rss"],
+								   [self xmlFile:@"broken" extension:@"rss"], [self xmlFile:@"scriptingNews" extension:@"rss"]];
+	NSMutableArray<RSParsedFeed*> *expected = [NSMutableArray new];
+	for (RSXMLData *xmlData in files) {
+		[expected addObject:[[xmlData getParser] parseSync:nil]];
+	}
+	// arenas are per thread. Interleave parses with and without arena on all cores.
+	dispatch_apply(64, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^(size_t i) {
+		RSFeedParser *parser = [files[i % files.count] getParser];
+		parser.useArena = (i / files.count) % 2;
+		RSParsedFeed *parsedFeed = [parser parseSync:nil];
+		XCTAssertEqualObjects(parsedFeed.title, expected[i % files.count].title);
+		XCTAssertEqual(parsedFeed.articles.count, expected[i % files.count].articles.count);
+	});
+}
+
+- (void)testLazyDecoding {
+	for (RSXMLData *xmlData in @[[self xmlFile:@"KatieFloyd" extension:@"rss"], [self xmlFile:@"DaringFireball" extension:@"atom"]]) {
+		RSParsedFeed *expected = [[xmlData getParser] parseSync:nil];
+		RSFeedParser *parser = [xmlData getParser];
+		parser.lazyDecoding = YES;
+		NSError *error = nil;
+		RSParsedFeed *parsedFeed = [parser parseSync:&error];
+		XCTAssertNil(error);
+		XCTAssertEqual(parsedFeed.articles.count, expected.articles.count);
+		// first access from many threads at once
+		dispatch_apply(parsedFeed.articles.count, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^(size_t i) {
+			[self compareArticle:parsedFeed.articles[i] with:expected.articles[i]];
+		});
+	}
+	RSXMLData *atomData = [self xmlFile:@"DaringFireball" extension:@"atom"];
+	RSFeedParser *custom = [RSUppercaseAtomParser parserWithXMLData:atomData];
+	custom.lazyDecoding = YES;
+	RSParsedFeed *customFeed = [custom parseSync:nil];
+	XCTAssertEqualObjects(customFeed.articles.firstObject.title, [[atomData getParser] parseSync:nil].articles.firstObject.title.uppercaseString);
+	
+	RSParsedArticle *article = [[RSParsedArticle alloc] initWithFeedURL:[NSURL URLWithString:@"http://example.org/"] dateParsed:[NSDate date]];
+	[article setRawCharacters:[@"  Tom &amp; Jerry \n" dataUsingEncoding:NSUTF8StringEncoding] forField:RSParsedArticleFieldTitle baseURL:nil];
+	[article setRawCharacters:[@" /a/b " dataUsingEncoding:NSUTF8StringEncoding] forField:RSParsedArticleFieldLink baseURL:[NSURL URLWithString:@"http://example.org/"]];
+	XCTAssertEqualObjects(article.title, @"Tom & Jerry");
+	XCTAssertEqualObjects(article.link, @"http://example.org/a/b");
+	[article setRawCharacters:[@"raw" dataUsingEncoding:NSUTF8StringEncoding] forField:RSParsedArticleFieldBody baseURL:nil];
+	article.body = @"set";
+	XCTAssertEqualObjects(article.body, @"set");
+}
+
+- (void)testSnapshot {
+	RSXMLData *xmlData = [self xmlFile:@"DaringFireball" extension:@"atom"];
+	RSParsedFeed *feed = [[xmlData getParser] parseSync:nil];
+	NSData *data = [RSXMLSnapshot dataWithFeed:feed];
+	XCTAssertNotNil(data);
+	
+	NSError *error = nil;
+	RSXMLSnapshot *snapshot = [[RSXMLSnapshot alloc] initWithData:data error:&error];
+	XCTAssertNil(error);
+	XCTAssertEqual(snapshot.kind, RSXMLSnapshotKindFeed);
+	XCTAssertEqual(snapshot.count, 47u);
+	NSUInteger length = 0;
+	const char *guid = [snapshot UTF8StringForArticleAtIndex:0 field:RSXMLSnapshotArticleGuid length:&length];
+	XCTAssertEqual(strcmp(guid, "tag:daringfireball.net,2016:/linked//6.32173"), 0);
+	XCTAssertEqual(length, strlen(guid));
+	XCTAssertEqualObjects([snapshot stringForArticleAtIndex:0 field:RSXMLSnapshotArticleID], feed.articles[0].articleID);
+	XCTAssertEqualObjects([snapshot datePublishedForArticleAtIndex:0], [NSDate dateWithTimeIntervalSince1970:1456610387]);
+	XCTAssertEqual([snapshot UTF8StringForArticleAtIndex:47 field:RSXMLSnapshotArticleID length:NULL], NULL);
+	XCTAssertEqualObjects([snapshot stringForFeedField:RSXMLSnapshotFeedTitle], feed.title);
+	XCTAssertEqual(strcmp([snapshot UTF8StringForFeedField:RSXMLSnapshotFeedURL length:NULL], feed.url.absoluteString.UTF8String), 0);
+	XCTAssertEqualWithAccuracy(snapshot.feedDateParsed.timeIntervalSince1970, feed.dateParsed.timeIntervalSince1970, 0.001);
+	XCTAssertEqual([snapshot childrenOfItemAtIndex:0].length, 0u);
+	
+	RSParsedFeed *restored = snapshot.parsedFeed;
+	XCTAssertEqualObjects(restored.url, feed.url);
+	XCTAssertEqualWithAccuracy(restored.dateParsed.timeIntervalSince1970, feed.dateParsed.timeIntervalSince1970, 0.001);
+	[self compareFeed:restored with:feed];
+	XCTAssertNil(snapshot.opmlItem);
+	
+	XCTAssertNil([[RSXMLSnapshot alloc] initWithData:[data subdataWithRange:NSMakeRange(0, 100)] error:&error]);
+	XCTAssertEqual(error.code, RSXMLErrorSnapshotMalformed);
+	NSMutableData *newer = [data mutableCopy];
+	((uint8_t *)newer.mutableBytes)[4] = 99; // version
+	XCTAssertNil([[RSXMLSnapshot alloc] initWithData:newer error:&error]);
+	XCTAssertEqual(error.code, RSXMLErrorSnapshotVersion);
+	
+	[self measureBlock:^{
+		[[[RSXMLSnapshot alloc] initWithData:data error:nil] parsedFeed];
+	}];
+}
+
+- (void)testEventReaderEarlyExit {
+	RSXMLData *xmlData = [self xmlFile:@"DaringFireball" extension:@"atom"];
+	__weak RSXMLEventReader *weakReader = nil;
+	@autoreleasepool {
+		RSXMLEventReader *reader = [[RSXMLEventReader alloc] initWithData:xmlData.data];
+		weakReader = reader;
+		RSXMLEvent e;
+		while ((e = [reader nextEvent]).type != RSXMLEventEndDocument) {
+			if (e.type == RSXMLEventStartElement && strcmp(e.name, "entry") == 0) {
+				break; // found what we were looking for
+			}
+		}
+		XCTAssertEqual(e.type, RSXMLEventStartElement);
+	}
+	XCTAssertNil(weakReader);
+}
+
+- (void)testEventReader {
+	RSXMLData *xmlData = [self xmlFile:@"DaringFireball" extension:@"atom"];
+	RSXMLEventReader *reader = [[RSXMLEventReader alloc] initWithData:xmlData.data];
+	NSMutableArray<NSString*> *titles = [NSMutableArray array];
+	NSMutableArray<NSString*> *links = [NSMutableArray array];
+	NSMutableData *text = nil;
+	NSUInteger textDepth = 0, numberOfEntries = 0;
+	BOOL didSkip = NO;
+	RSXMLEvent e;
+	while ((e = [reader nextEvent]).type != RSXMLEventEndDocument) {
+		if (didSkip) { // next event after </content> belongs to <entry>
+			XCTAssertEqual(e.depth, 2u);
+			didSkip = NO;
+		}
+		switch (e.type) {
+			case RSXMLEventStartElement:
+				if (strcmp(e.name, "entry") == 0) {
+					numberOfEntries++;
+				} else if (strcmp(e.name, "content") == 0) {
+					[reader skipSubtree];
+					didSkip = YES;
+				} else if (e.depth == 3 && strcmp(e.name, "title") == 0) {
+					text = [NSMutableData data];
+					textDepth = e.depth;
+				} else if (e.depth == 3 && strcmp(e.name, "link") == 0) {
+					NSUInteger length = 0;
+					const char *rel = [reader valueForAttribute:"rel" length:&length];
+					if (rel && length == 9 && memcmp(rel, "alternate", 9) == 0) {
+						const char *href = [reader valueForAttribute:"href" length:&length];
+						[links addObject:[[NSString alloc] initWithBytes:href length:length encoding:NSUTF8StringEncoding]];
+					}
+				}
+				break;
+			case RSXMLEventText:
+				if (text && e.depth == textDepth) {
+					[text appendBytes:e.bytes length:e.length];
+				}
+				break;
+			case RSXMLEventEndElement:
+				if (text && e.depth == textDepth) {
+					[titles addObject:[[NSString alloc] initWithData:text encoding:NSUTF8StringEncoding]];
+					text = nil;
+				}
+				break;
+			default: break;
+		}
+	}
+	XCTAssertNil(reader.parsingError);
+	XCTAssertEqual(numberOfEntries, 47u);
+	XCTAssertEqual(titles.count, 47u);
+	XCTAssertEqual(links.count, 47u);
+	XCTAssertEqualObjects(titles.firstObject, @"Apple Product Event: Monday March 21");
+	XCTAssertEqualObjects(links.firstObject, @"http://recode.net/2016/02/27/remark-your-calendars-apples-product-event-will-week-of-march-21/");
+	XCTAssertEqual([reader nextEvent].type, RSXMLEventEndDocument);
+}
+
+- (void)testSAXEventDispatchPerformance {
+	NSMutableData *xml = [NSMutableData dataWithBytes:"<root>" length:6];
+	for (int i = 0; i < 100000; i++) {
+		[xml appendBytes:"<a>x</a>" length:8];
+	}
+	[xml appendBytes:"</root>" length:7];
+	
+	RSSAXEventCounter *counter = [RSSAXEventCounter new];
+	RSSAXParser *parser = [[RSSAXParser alloc] initWithDelegate:counter];
+	[parser parseBytes:xml.bytes numberOfBytes:xml.length];
+	XCTAssertEqual(counter.numberOfEvents, 300002u); // 100001 start + end, 100000 characters
+	
+	[self measureBlock:^{
+		[parser parseBytes:xml.bytes numberOfBytes:xml.length];
+	}];
+}
+
 - (void)testHttpSchemePrepending {
 	NSError *error = nil;
 	RSXMLData *xmlData = [self xmlFile:@"ccc-media" extension:@"rdf"];